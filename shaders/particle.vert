@@ -1,12 +1,13 @@
 #version 330 core
 layout (location = 0) in vec4 vertex;
+// One particle per instance
+layout (location = 1) in vec2 offset;
+layout (location = 2) in vec4 color;
 
 out vec2 TexCoords;
 out vec4 ParticleColor;
 
 uniform mat4 projection;
-uniform vec2 offset;
-uniform vec4 color;
 
 void main() {
     float scale = 10.0;
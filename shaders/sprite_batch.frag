@@ -0,0 +1,11 @@
+#version 330 core
+out vec4 color;
+
+in vec2 TexCoords;
+in vec3 SpriteColor;
+
+uniform sampler2D image;
+
+void main() {
+    color = vec4(SpriteColor, 1.0) * texture(image, TexCoords);
+}
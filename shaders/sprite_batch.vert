@@ -0,0 +1,26 @@
+#version 330 core
+
+layout (location = 0) in vec4 vertex;
+// One sprite per instance
+layout (location = 1) in vec4 rect;   // position, size
+layout (location = 2) in vec4 tint;   // color, rotation in radians
+layout (location = 3) in vec4 region; // offset, scale in the texture
+
+out vec2 TexCoords;
+out vec3 SpriteColor;
+
+uniform mat4 projection;
+
+void main() {
+    // The model matrix of sprite.vert: scale, rotate around the center,
+    // then move into place
+    vec2 local = (vertex.xy - 0.5) * rect.zw;
+    float s = sin(tint.w);
+    float c = cos(tint.w);
+    vec2 rotated = vec2(c * local.x - s * local.y,
+                        s * local.x + c * local.y);
+    TexCoords = region.xy + vertex.zw * region.zw;
+    SpriteColor = tint.rgb;
+    gl_Position = projection *
+        vec4(rect.xy + rect.zw * 0.5 + rotated, 0.0, 1.0);
+}
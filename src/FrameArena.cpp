@@ -0,0 +1,74 @@
+#include "FrameArena.h"
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+FrameArena* FrameArena::GetInstance() {
+    static FrameArena arena;
+    return &arena;
+}
+
+FrameArena::FrameArena(std::size_t capacity)
+    : block(new char[capacity])
+    , capacity(capacity) {
+}
+
+void* FrameArena::Allocate(std::size_t size, std::size_t align) {
+    auto base = reinterpret_cast<std::uintptr_t>(block.get());
+    std::size_t start = ((base + offset + align - 1) & ~(align - 1)) - base;
+    if (start + size <= capacity) {
+        used += start - offset + size;
+        offset = start + size;
+        peak = std::max(peak, used);
+        return block.get() + start;
+    }
+
+    // out of room, give this allocation a block of its own until the
+    // next reset grows the arena
+    std::size_t bytes = size + align;
+    overflow.emplace_back(new char[bytes]);
+    overflowBytes += bytes;
+    used += size;
+    peak = std::max(peak, used);
+    auto p = reinterpret_cast<std::uintptr_t>(overflow.back().get());
+    return reinterpret_cast<void*>((p + align - 1) & ~(align - 1));
+}
+
+std::string_view
+FrameArena::Concat(std::initializer_list<std::string_view> parts) {
+    std::size_t length = 0;
+    for (auto part : parts) {
+        length += part.size();
+    }
+    char* out = Allocate<char>(length + 1);
+    char* cursor = out;
+    for (auto part : parts) {
+        std::memcpy(cursor, part.data(), part.size());
+        cursor += part.size();
+    }
+    *cursor = '\0';
+    return std::string_view(out, length);
+}
+
+void FrameArena::Reset() {
+    if (!overflow.empty()) {
+        capacity += overflowBytes;
+        block.reset(new char[capacity]);
+        overflow.clear();
+        overflowBytes = 0;
+    }
+    offset = 0;
+    used = 0;
+}
+
+char* FrameArena::tail(std::size_t& available) {
+    available = capacity - offset;
+    return block.get() + offset;
+}
+
+void FrameArena::commit(std::size_t size) {
+    offset += size;
+    used += size;
+    peak = std::max(peak, used);
+}
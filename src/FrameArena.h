@@ -0,0 +1,81 @@
+#ifndef __FRAMEARENA_H__
+#define __FRAMEARENA_H__
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <string_view>
+#include <initializer_list>
+
+#include <fmt/core.h>
+
+// Bump allocator for data that only lives until the end of the current
+// frame: formatted text, temporary paths and the like. Nothing allocated
+// here is ever freed individually, Reset() rewinds the whole arena once
+// the frame has been presented.
+class FrameArena {
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY = 64 * 1024;
+
+    static FrameArena* GetInstance();
+
+    explicit FrameArena(std::size_t capacity = DEFAULT_CAPACITY);
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* Allocate(std::size_t size,
+                   std::size_t align = alignof(std::max_align_t));
+
+    template <typename T>
+    T* Allocate(std::size_t count) {
+        return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    // Format into the arena. The returned view is null terminated.
+    template <typename... Args>
+    std::string_view Format(fmt::format_string<Args...> format,
+                            Args&&... args) {
+        std::size_t available = 0;
+        char* out = tail(available);
+        auto formatArgs = fmt::make_format_args(args...);
+        auto result = fmt::vformat_to_n(out, available, format, formatArgs);
+        if (result.size >= available) {
+            // did not fit the current block, allocate exactly what is needed
+            out = Allocate<char>(result.size + 1);
+            fmt::vformat_to(out, format, formatArgs);
+        } else {
+            commit(result.size + 1);
+        }
+        out[result.size] = '\0';
+        return std::string_view(out, result.size);
+    }
+
+    // Concatenate the parts into the arena. The returned view is null
+    // terminated.
+    std::string_view Concat(std::initializer_list<std::string_view> parts);
+
+    // Release everything allocated since the last reset. If the frame
+    // spilled over into extra blocks the arena grows to fit them so the
+    // next frame does not spill again.
+    void Reset();
+
+    std::size_t Used() const { return used; }
+    std::size_t Capacity() const { return capacity; }
+    std::size_t Peak() const { return peak; }
+
+private:
+
+    std::unique_ptr<char[]> block;
+    std::size_t capacity;
+    std::size_t offset = 0;
+    std::size_t used = 0;
+    std::size_t peak = 0;
+    // blocks taken when the main one ran out during this frame
+    std::vector<std::unique_ptr<char[]>> overflow;
+    std::size_t overflowBytes = 0;
+
+    char* tail(std::size_t& available);
+    void commit(std::size_t size);
+};
+
+#endif
@@ -0,0 +1,139 @@
+#include "GLState.h"
+
+#include <cassert>
+
+GLState* GLState::GetInstance() {
+    static GLState state;
+    return &state;
+}
+
+GLState::GLState() {
+    Invalidate();
+}
+
+bool GLState::change(GLuint& current, GLuint value) {
+    if (current == value) {
+        ++stats.filtered;
+        return false;
+    }
+    current = value;
+    ++stats.issued;
+    return true;
+}
+
+void GLState::forget(GLuint& current, GLuint deleted) {
+    if (current == deleted) {
+        current = 0;
+    }
+}
+
+void GLState::UseProgram(GLuint program) {
+    if (change(this->program, program)) {
+        glUseProgram(program);
+    }
+}
+
+void GLState::BindVertexArray(GLuint vao) {
+    if (change(this->vao, vao)) {
+        glBindVertexArray(vao);
+    }
+}
+
+void GLState::BindArrayBuffer(GLuint buffer) {
+    if (change(arrayBuffer, buffer)) {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    }
+}
+
+void GLState::StreamArrayBuffer(GLuint buffer, GLsizeiptr capacity,
+                                const void* data, GLsizeiptr size) {
+    BindArrayBuffer(buffer);
+    // Orphan the last frame's storage instead of waiting for the GPU to
+    // finish reading it
+    glBufferData(GL_ARRAY_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
+}
+
+void GLState::BindTexture(int unit, GLuint texture) {
+    assert(unit >= 0 && unit < MAX_TEXTURE_UNITS);
+    if (textures[unit] == texture) {
+        ++stats.filtered;
+        return;
+    }
+    if (change(activeUnit, unit)) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+    }
+    change(textures[unit], texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+}
+
+void GLState::BlendFunc(GLenum src, GLenum dst) {
+    if (blendSrc == src && blendDst == dst) {
+        ++stats.filtered;
+        return;
+    }
+    blendSrc = src;
+    blendDst = dst;
+    ++stats.issued;
+    glBlendFunc(src, dst);
+}
+
+void GLState::BindFramebuffer(GLenum target, GLuint framebuffer) {
+    bool changed = false;
+    if (target != GL_DRAW_FRAMEBUFFER && readFramebuffer != framebuffer) {
+        readFramebuffer = framebuffer;
+        changed = true;
+    }
+    if (target != GL_READ_FRAMEBUFFER && drawFramebuffer != framebuffer) {
+        drawFramebuffer = framebuffer;
+        changed = true;
+    }
+    if (!changed) {
+        ++stats.filtered;
+        return;
+    }
+    ++stats.issued;
+    glBindFramebuffer(target, framebuffer);
+}
+
+void GLState::DeleteProgram(GLuint program) {
+    // A program in use is only deleted once it is not any more
+    glDeleteProgram(program);
+}
+
+void GLState::DeleteVertexArray(GLuint vao) {
+    forget(this->vao, vao);
+    glDeleteVertexArrays(1, &vao);
+}
+
+void GLState::DeleteBuffer(GLuint buffer) {
+    forget(arrayBuffer, buffer);
+    glDeleteBuffers(1, &buffer);
+}
+
+void GLState::DeleteTexture(GLuint texture) {
+    for (auto& bound : textures) {
+        forget(bound, texture);
+    }
+    glDeleteTextures(1, &texture);
+}
+
+void GLState::DeleteFramebuffer(GLuint framebuffer) {
+    forget(readFramebuffer, framebuffer);
+    forget(drawFramebuffer, framebuffer);
+    glDeleteFramebuffers(1, &framebuffer);
+}
+
+void GLState::Invalidate() {
+    program = UNKNOWN;
+    vao = UNKNOWN;
+    arrayBuffer = UNKNOWN;
+    activeUnit = UNKNOWN;
+    for (auto& texture : textures) {
+        texture = UNKNOWN;
+    }
+    blendSrc = UNKNOWN;
+    blendDst = UNKNOWN;
+    readFramebuffer = UNKNOWN;
+    drawFramebuffer = UNKNOWN;
+}
@@ -0,0 +1,72 @@
+#ifndef __GLSTATE_H__
+#define __GLSTATE_H__
+
+#include <cstdint>
+
+#include <glad/glad.h>
+
+struct GLStateStats {
+    // Changes passed on to GL
+    std::uint64_t issued = 0;
+    // Changes dropped because GL was in that state already
+    std::uint64_t filtered = 0;
+};
+
+// The GL state the renderers change, tracked so that setting what is
+// set already costs no call. Every bind of these goes through here,
+// code changing them directly has to call Invalidate() afterwards.
+class GLState {
+public:
+    static const int MAX_TEXTURE_UNITS = 16;
+
+    static GLState* GetInstance();
+
+    void UseProgram(GLuint program);
+    void BindVertexArray(GLuint vao);
+    void BindArrayBuffer(GLuint buffer);
+    // Binds buffer and replaces its contents with the first size bytes
+    // of a new capacity byte storage, for data streamed every frame
+    void StreamArrayBuffer(GLuint buffer, GLsizeiptr capacity,
+                           const void* data, GLsizeiptr size);
+    // Binds a GL_TEXTURE_2D, switching the active unit only if needed
+    void BindTexture(int unit, GLuint texture);
+    void BlendFunc(GLenum src, GLenum dst);
+    // target is GL_FRAMEBUFFER, GL_READ_FRAMEBUFFER or
+    // GL_DRAW_FRAMEBUFFER
+    void BindFramebuffer(GLenum target, GLuint framebuffer);
+
+    // GL unbinds what is deleted, these forget it as well
+    void DeleteProgram(GLuint program);
+    void DeleteVertexArray(GLuint vao);
+    void DeleteBuffer(GLuint buffer);
+    void DeleteTexture(GLuint texture);
+    void DeleteFramebuffer(GLuint framebuffer);
+
+    // The next change of everything is issued
+    void Invalidate();
+
+    const GLStateStats& Stats() const { return stats; }
+    void ResetStats() { stats = GLStateStats(); }
+
+private:
+    // Never a GL name, so the first change always goes through
+    static const GLuint UNKNOWN = ~0u;
+
+    GLuint program = UNKNOWN;
+    GLuint vao = UNKNOWN;
+    GLuint arrayBuffer = UNKNOWN;
+    GLuint activeUnit = UNKNOWN;
+    GLuint textures[MAX_TEXTURE_UNITS];
+    GLuint blendSrc = UNKNOWN;
+    GLuint blendDst = UNKNOWN;
+    GLuint readFramebuffer = UNKNOWN;
+    GLuint drawFramebuffer = UNKNOWN;
+    GLStateStats stats;
+
+    GLState();
+    // Records value as the current one, false if it was already
+    bool change(GLuint& current, GLuint value);
+    void forget(GLuint& current, GLuint deleted);
+};
+
+#endif
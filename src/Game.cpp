@@ -4,7 +4,6 @@
 #include <cmath>
 #include <cassert>
 #include <algorithm>
-#include <functional>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -13,12 +12,16 @@
 #include <fmt/core.h>
 #include <ik/irrKlang.h>
 
-#include "Ball.h"
-#include "GameLevel.h"
-#include "GameObject.h"
+#include "sim/AllocTracker.h"
+#include "sim/Ball.h"
+#include "sim/GameLevel.h"
+#include "sim/GameObject.h"
+#include "sim/PowerUp.h"
+#include "sim/Replay.h"
+#include "sim/SaveState.h"
+#include "FrameArena.h"
 #include "Particle.h"
 #include "PostProcessor.h"
-#include "PowerUp.h"
 #include "ResourceManager.h"
 #include "Shader.h"
 #include "SpriteRenderer.h"
@@ -27,81 +30,63 @@
 
 irrklang::ISoundEngine *soundEngine = irrklang::createIrrKlangDevice();
 
-float shakeTime = 0.0f;
-
-const glm::vec2 BALL_VELOCITY = glm::vec2(200.0f, -200.0f);
-const glm::vec2 PLAYER_SIZE = glm::vec2(100.0f, 20.0f);
+// Room for the widest sprite texture and a few of the small ones beside
+static const int SPRITE_ATLAS_WIDTH = 2048;
 
 Game::Game(int width, int height)
     : Width(width)
-    , Height(height) { }
+    , Height(height)
+    , sim(width, height) { }
+
+Game::~Game() {
+    StopRecording();
+}
 
-Game::~Game() { }
+bool Game::StartRecording(const std::string& path) {
+    recorder = std::make_unique<ReplayWriter>();
+    if (!recorder->Open(path, MakeReplayHeader(sim))) {
+        recorder.reset();
+        return false;
+    }
+    return true;
+}
+
+void Game::StopRecording() {
+    if (recorder) {
+        recorder->Close(HashState(sim));
+        recorder.reset();
+    }
+}
+
+bool Game::StartReplay(const std::string& path) {
+    replay = std::make_unique<ReplayReader>();
+    if (!replay->Open(path) || !ApplyReplayHeader(replay->Header(), sim)) {
+        replay.reset();
+        return false;
+    }
+    return true;
+}
 
 void Game::Init() {
     loadResources();
 
     auto spriteShader = ResourceManager::GetInstance()->
         GetShader("sprite");
-    sprite_renderer = std::make_unique<SpriteRenderer>(spriteShader);
+    auto batchShader = ResourceManager::GetInstance()->
+        GetShader("sprite_batch");
+    sprite_renderer = std::make_unique<SpriteRenderer>(spriteShader,
+                                                       batchShader);
 
     auto fontShader = ResourceManager::GetInstance()->
         GetShader("text");
     text_renderer = std::make_unique<TextRenderer>(fontShader);
 
-    // Player
-    GameObjectAttribute attr;
-    attr.size = glm::vec2(100.0f, 20.0f);
-    attr.position = glm::vec2(this->Width / 2 - attr.size.x / 2,
-                              this->Height - attr.size.y);
-    attr.velocity = glm::vec2(0.0f, 0.0f);
-    attr.color = glm::vec3(1.0f, 1.0f, 1.0f);
-    attr.rotation = 0;
-    attr.isSolid = true;
-    attr.isDestroyed = false;
-    attr.texture = ResourceManager::GetInstance()->
-        GetTexture2D("paddle");
-    player = std::make_unique<GameObject>(attr);
-    objects.insert(player.get());
-
-    // Ball
-    BallAttribute ballAttr;
-    ballAttr.radius = 10.0f;
-    ballAttr.isStatic = true;
-
-    ballAttr.size = glm::vec2(2 * ballAttr.radius);
-    ballAttr.position = player->Attr()->position +
-        glm::vec2(player->Attr()->size.x / 2 - ballAttr.radius,
-                  -2 * ballAttr.radius - 1.0f);
-    ballAttr.velocity = BALL_VELOCITY;
-    ballAttr.color = glm::vec3(1.0f);
-    ballAttr.rotation = 0.0f;
-    ballAttr.isSolid = true;
-    ballAttr.isDestroyed = false;
-    ballAttr.texture = ResourceManager::GetInstance()->
-        GetTexture2D("face");
-    ball = std::make_unique<Ball>(ballAttr);
-    player->children.insert(ball.get());
-
-    // Boundary
-    attr.size = glm::vec2(Width, 1.0f);
-    attr.position = glm::vec2(0.0f, -1.0f);
-    attr.isSolid = true;
-    attr.isDestroyed = false;
-    boundary.emplace_back(std::make_unique<GameObject>(attr));
-
-    attr.size = glm::vec2(1.0f, Height);
-    attr.position = glm::vec2(-1.0f, 0.0f);
-    boundary.emplace_back(std::make_unique<GameObject>(attr));
-
-    attr.position = glm::vec2(Width, 0.0f);
-    boundary.emplace_back(std::make_unique<GameObject>(attr));
-
     particles = std::make_unique<ParticleGenerator>(
-            500,
+            particleCount,
             ResourceManager::GetInstance()->GetShader("particle"),
             ResourceManager::GetInstance()->GetTexture2D("particle")
         );
+    particles->Seed(sim.GetSeed());
 
     effects = std::make_unique<PostProcessor>(
         ResourceManager::GetInstance()->GetShader("postprocess"),
@@ -114,71 +99,115 @@ void Game::Init() {
         true);
 }
 
+bool Game::consumeKey(int key) {
+    if (Keys[key] && !Processed[key]) {
+        Processed[key] = true;
+        return true;
+    }
+    return false;
+}
+
 void Game::ProcessInput(float dt) {
-    if (State == GameState::GAME_ACTIVE) {
-        auto& playerAttr = *player->Attr();
-        if (Keys[GLFW_KEY_A] && Keys[GLFW_KEY_D] ||
-            !Keys[GLFW_KEY_A] && !Keys[GLFW_KEY_D]) {
-            playerAttr.velocity.x = 0.0f;
-        } else if (Keys[GLFW_KEY_A]) {
-            playerAttr.velocity.x = -500.0f;
+    input.left = Keys[GLFW_KEY_A];
+    input.right = Keys[GLFW_KEY_D];
+    input.launch = Keys[GLFW_KEY_SPACE];
+    // Presses are kept until a step consumes them, a frame may not run
+    // any step at all
+    input.prevLevel |= consumeKey(GLFW_KEY_W);
+    input.nextLevel |= consumeKey(GLFW_KEY_S);
+    input.confirm |= consumeKey(GLFW_KEY_ENTER);
+    input.skipLevel |= consumeKey(GLFW_KEY_C);
+
+    // - and = halve and double the speed, 0 goes back to real time
+    if (consumeKey(GLFW_KEY_MINUS)) {
+        SetTimeScale(timeScale / 2.0f);
+    }
+    if (consumeKey(GLFW_KEY_EQUAL)) {
+        SetTimeScale(timeScale * 2.0f);
+    }
+    if (consumeKey(GLFW_KEY_0)) {
+        SetTimeScale(1.0f);
+    }
+    if (consumeKey(GLFW_KEY_F)) {
+        fastForward = !fastForward;
+    }
+
+    // A failed capture keeps the snapshot taken before
+    if (consumeKey(GLFW_KEY_F5)) {
+        if (Capture(quickSave)) {
+            hasQuickSave = true;
         } else {
-            playerAttr.velocity.x = 500.0f;
+            fmt::print("Snapshot failed, it holds at most {} balls, {} "
+                       "power-ups and {} bricks!\n", MAX_SNAPSHOT_BALLS,
+                       MAX_SNAPSHOT_POWER_UPS, MAX_SNAPSHOT_BRICK_WORDS * 64);
         }
+    }
+    if (consumeKey(GLFW_KEY_F9) && hasQuickSave) {
+        Restore(quickSave);
+    }
+    if (consumeKey(GLFW_KEY_F6) && WriteSaveState(savePath, sim)) {
+        fmt::print("Saved to {}\n", savePath);
+    }
+}
 
-        if (Keys[GLFW_KEY_SPACE] && ball->Attr()->isStatic) {
-            ball->Attr()->isStatic = false;
-            player->children.erase(ball.get());
-            objects.insert(ball.get());
-        }
+void Game::SetTimeScale(float scale) {
+    timeScale = std::clamp(scale, MIN_TIME_SCALE, MAX_TIME_SCALE);
+}
 
-        if (Keys[GLFW_KEY_C] && !Processed[GLFW_KEY_C]) {
-            effects->chaos = true;
-            State = GameState::GAME_WIN;
-        }
-    } else if (State == GameState::GAME_MENU) {
-        if (Keys[GLFW_KEY_W] && !Processed[GLFW_KEY_W]) {
-            --level;
-            level = (level + 4) % 4;
-            Processed[GLFW_KEY_W] = true;
-        }
-        if (Keys[GLFW_KEY_S] && !Processed[GLFW_KEY_S]) {
-            ++level;
-            level %= 4;
-            Processed[GLFW_KEY_S] = true;
-        }
-        if (Keys[GLFW_KEY_ENTER] && !Processed[GLFW_KEY_ENTER]) {
-            State = GameState::GAME_ACTIVE;
-            Processed[GLFW_KEY_ENTER] = true;
-            reset_player();
-            reset_ball();
-            clear_powerups();
-            player->children.insert(ball.get());
-            objects.erase(ball.get());
-            play_ball = 2;
-        }
-    } else if (State == GameState::GAME_WIN) {
-        if (Keys[GLFW_KEY_ENTER] && !Processed[GLFW_KEY_ENTER]) {
-            reset_level();
-            effects->chaos = false;
-            State = GameState::GAME_MENU;
-            Processed[GLFW_KEY_ENTER] = true;
-        }
-    }
+bool Game::Capture(GameSnapshot& snapshot) const {
+    snapshot.shakeTime = shakeTime;
+    snapshot.shake = effects->shake;
+    return sim.Capture(snapshot.sim);
+}
 
+bool Game::Restore(const GameSnapshot& snapshot) {
+    // The recording ends in the state the game leaves
+    StopRecording();
+    replay.reset();
+    if (!sim.Restore(snapshot.sim)) {
+        return false;
+    }
+    shakeTime = snapshot.shakeTime;
+    effects->shake = snapshot.shake;
+    effects->confuse = sim.GetEffects().confuse;
+    effects->chaos = sim.GetEffects().chaos;
+    return true;
 }
 
 void Game::Update(float dt) {
-    if (State == GameState::GAME_ACTIVE) {
-        for (auto& object : objects) {
-            object->Update(dt);
+    ALLOC_SCOPE("Game::Update");
+    if (replay) {
+        float recordedDt;
+        if (replay->Next(input, recordedDt)) {
+            dt = recordedDt;
+        } else {
+            fmt::print("Replay finished, final state {}\n",
+                       HashState(sim) == replay->Header().finalState ?
+                       "matches" : "differs");
+            replay.reset();
+            input = InputState();
         }
-        doCollision();
+    }
+    if (recorder) {
+        recorder->Record(input, dt);
+    }
 
-        particles->Update(dt, ball.get(), 2,
-                          glm::vec2(ball->Attr()->radius / 2.0f));
+    sim.ProcessInput(input);
+    input.prevLevel = false;
+    input.nextLevel = false;
+    input.confirm = false;
+    input.skipLevel = false;
 
-        updatePowerUps(dt);
+    sim.Update(dt);
+    // Nothing is played in fast-forward
+    if (!fastForward) {
+        frameEvents.Add(sim.Events());
+    }
+
+    if (sim.State == GameState::GAME_ACTIVE) {
+        // The trail follows the ball served at the start of the round
+        const Ball* ball = sim.GetBalls().front().get();
+        particles->Update(dt, ball, 2, glm::vec2(ball->radius / 2.0f));
 
         if (shakeTime > 0.0f) {
             shakeTime -= dt;
@@ -186,27 +215,46 @@ void Game::Update(float dt) {
                 effects->shake = false;
             }
         }
+    }
 
-        if (ball->Attr()->position.y > Height + 200) {
-            --play_ball;
-            if (play_ball >= 0) {
-                reset_player();
-                reset_ball();
-                player->children.insert(ball.get());
-                objects.erase(ball.get());
-            } else {
-                State = GameState::GAME_MENU;
-            }
-        }
+    effects->confuse = sim.GetEffects().confuse;
+    effects->chaos = sim.GetEffects().chaos;
+}
 
-        if (levels[level]->IsComplete()) {
-            State = GameState::GAME_WIN;
-            effects->chaos = true;
+void Game::HandleEvents() {
+    // Many hits of the same kind in one frame sound like one, so each
+    // kind plays once and the shake starts once
+    static const struct {
+        SimEventType type;
+        const char* sound;
+    } sounds[] = {
+        { SimEventType::BrickDestroyed, "resources/audio/bleep.mp3" },
+        { SimEventType::SolidBrickHit, "resources/audio/solid.wav" },
+        { SimEventType::PaddleHit, "resources/audio/bleep.wav" },
+        { SimEventType::PowerUpCollected, "resources/audio/powerup.wav" },
+    };
+    if (frameEvents.Empty()) {
+        return;
+    }
+    if (frameEvents.Count(SimEventType::SolidBrickHit)) {
+        shakeTime = 0.05f;
+        effects->shake = true;
+    }
+    for (const auto& sound : sounds) {
+        if (!frameEvents.Count(sound.type) || fastForward) {
+            continue;
         }
+        // irrKlang allocates for every sound it starts
+        AllocTracker::Permit permit;
+        soundEngine->play2D(
+            ResourceManager::GetInstance()->FrameAbsolutePath(sound.sound),
+            false);
     }
+    frameEvents.Clear();
 }
 
-void Game::Render() {
+void Game::Render(float alpha) {
+    ALLOC_SCOPE("Game::Render");
     effects->BeginRender();
 
     auto background = ResourceManager::GetInstance()->
@@ -215,20 +263,46 @@ void Game::Render() {
                    glm::vec2(this->Width, this->Height), 0.0f,
                    glm::vec3(1.0f, 1.0f, 1.0f));
 
-    levels[level]->Draw(*sprite_renderer);
-    for (auto& p : powerUps) {
-        if (!p->Attr()->isDestroyed) {
-            p->Draw(*sprite_renderer);
+    // Bricks never overlap each other, neither do power-ups, so each
+    // layer is one batch
+    const auto& bricks = sim.GetLevel()->bricks;
+    for (EntityStore::Index i = 0; i < bricks.Size(); ++i) {
+        if (bricks.IsAlive(i)) {
+            drawEntity(bricks, i);
+        }
+    }
+    sprite_renderer->Flush();
+    for (const PowerUp* p : sim.GetPowerUps()) {
+        if (!p->IsDestroyed()) {
+            drawObject(p, alpha);
         }
     }
-    player->Draw(*sprite_renderer);
+    sprite_renderer->Flush();
+    drawObject(sim.GetPlayer(), alpha);
+    sprite_renderer->Flush();
     particles->Draw();
-    ball->Draw(*sprite_renderer);
+    for (auto& ball : sim.GetBalls()) {
+        drawObject(ball.get(), alpha);
+    }
+    sprite_renderer->Flush();
 
-    text_renderer->RenderText(fmt::format("Ball: {}", play_ball),
+    FrameArena* arena = FrameArena::GetInstance();
+    text_renderer->RenderText(arena->Format("Ball: {}", sim.GetLives()),
                              glm::vec2(0.0f, 0.0f), 0.5f);
+    text_renderer->RenderText(
+        arena->Format("Cleared: {:.0f}%",
+                      sim.GetLevel()->Progress() * 100.0f),
+        glm::vec2(Width - 160.0f, 0.0f), 0.5f);
+
+    if (fastForward) {
+        text_renderer->RenderText("Fast-forward",
+                                 glm::vec2(Width / 2 - 60.0f, 0.0f), 0.5f);
+    } else if (timeScale != 1.0f) {
+        text_renderer->RenderText(arena->Format("{:g}x", timeScale),
+                                 glm::vec2(Width / 2 - 20.0f, 0.0f), 0.5f);
+    }
 
-    if (State == GameState::GAME_MENU) {
+    if (sim.State == GameState::GAME_MENU) {
         text_renderer->RenderText("Press ENTER to start",
                                  glm::vec2(Width / 2 - 150, Height / 2 - 50),
                                  0.75f);
@@ -237,7 +311,7 @@ void Game::Render() {
                                  0.75f);
     }
 
-    if (State == GameState::GAME_WIN) {
+    if (sim.State == GameState::GAME_WIN) {
         text_renderer->RenderText("You Won!",
                                  glm::vec2(Width / 2 - 100, Height / 2 - 50),
                                  0.75f);
@@ -250,6 +324,22 @@ void Game::Render() {
     effects->Render((float)glfwGetTime());
 }
 
+void Game::drawObject(const GameObject* object, float alpha) {
+    drawEntity(object->Store(), object->Index(), alpha);
+}
+
+void Game::drawEntity(const EntityStore& store, EntityStore::Index i,
+                      float alpha) {
+    glm::vec2 position = alpha < 1.0f ?
+        glm::mix(store.previousPositions[i], store.positions[i], alpha) :
+        store.positions[i];
+    sprite_renderer->Submit(sprites[(int)store.sprites[i]],
+                            position,
+                            store.sizes[i],
+                            store.rotations[i],
+                            store.colors[i]);
+}
+
 void Game::loadResources() {
     auto spriteShader = ResourceManager::GetInstance()->
         LoadShader("sprite", "shaders/sprite.vert",
@@ -260,6 +350,12 @@ void Game::loadResources() {
     spriteShader->use();
     spriteShader->setMat4("projection", projection);
 
+    auto batchShader = ResourceManager::GetInstance()->
+        LoadShader("sprite_batch", "shaders/sprite_batch.vert",
+                   "shaders/sprite_batch.frag");
+    batchShader->use();
+    batchShader->setMat4("projection", projection);
+
     auto particleShader = ResourceManager::GetInstance()->
         LoadShader("particle", "shaders/particle.vert",
                    "shaders/particle.frag");
@@ -281,364 +377,54 @@ void Game::loadResources() {
     ResourceManager::GetInstance()->
         LoadTexture2D("resources/textures/particle.png",
                       "particle", false);
-    ResourceManager::GetInstance()->
-        LoadTexture2D("resources/textures/awesomeface.png", "face",
-                      true);
     ResourceManager::GetInstance()->
         LoadTexture2D("resources/textures/background.jpg",
                       "background");
-    ResourceManager::GetInstance()->
-        LoadTexture2D("resources/textures/block.png", "brick");
-    ResourceManager::GetInstance()->
-        LoadTexture2D("resources/textures/block_solid.png",
-                      "brick_solid");
-    ResourceManager::GetInstance()->
-        LoadTexture2D("resources/textures/paddle.png", "paddle");
-    ResourceManager::GetInstance()->
-        LoadTexture2D("resources/textures/powerup_chaos.png",
-                      "chaos");
-    ResourceManager::GetInstance()->
-        LoadTexture2D("resources/textures/powerup_confuse.png",
-                      "confuse");
-    ResourceManager::GetInstance()->
-        LoadTexture2D("resources/textures/powerup_increase.png",
-                      "pad-size-increase");
-    ResourceManager::GetInstance()->
-        LoadTexture2D("resources/textures/powerup_passthrough.png",
-                      "pass-through");
-    ResourceManager::GetInstance()->
-        LoadTexture2D("resources/textures/powerup_speed.png",
-                      "speed");
-    ResourceManager::GetInstance()->
-        LoadTexture2D("resources/textures/powerup_sticky.png",
-                      "sticky");
-    for (int i = 0; i < 4; ++i) {
-        levels.emplace_back(std::make_unique<GameLevel>());
-    }
-    levels[0]->Load("resources/levels/one.lvl",
-                    this->Width, this->Height / 2);
-    levels[1]->Load("resources/levels/two.lvl",
-                    this->Width, this->Height / 2);
-    levels[2]->Load("resources/levels/three.lvl",
-                    this->Width, this->Height / 2);
-    levels[3]->Load("resources/levels/four.lvl",
-                    this->Width, this->Height / 2);
-}
-
-void Game::doCollision() {
-    // Ball VS Bricks
-    for (auto& brick : levels[level]->bricks) {
-        auto info = checkCollision(ball.get(), brick.get());
-        if (!brick->Attr()->isDestroyed && info.isCollided) {
-            if (!brick->Attr()->isSolid) {
-                brick->Attr()->isDestroyed = true;
-                spawnPowerUps(brick.get());
-                if (!ball->Attr()->isPassThrough) {
-                    applyCollision(ball.get(), info);
-                }
-                soundEngine->play2D(
-                    ResourceManager::GetInstance()
-                        ->RelativePathToAbolutePath("resources/audio/bleep.mp3")
-                        .c_str(),
-                    false);
-            } else {
-                shakeTime = 0.05f;
-                effects->shake = true;
-                applyCollision(ball.get(), info);
-                soundEngine->play2D(
-                    ResourceManager::GetInstance()
-                        ->RelativePathToAbolutePath("resources/audio/solid.wav")
-                        .c_str(),
-                    false);
-            }
-        }
-    }
-
-    // Ball VS Boundary
-    for (auto& bound : boundary) {
-        auto info = checkCollision(ball.get(), bound.get());
-        if (info.isCollided) {
-            applyCollision(ball.get(), info);
-        }
-    }
-
-    // Ball VS Player
-    auto info = checkCollision(ball.get(), player.get());
-    if (!ball->Attr()->isStatic && info.isCollided) {
-        float playerCenter = player->Attr()->position.x +
-            player->Attr()->size.x / 2.0f;
-        float dist = ball->Attr()->position.x +
-            ball->Attr()->radius - playerCenter;
-        float percent = dist / (player->Attr()->size.x / 2.0f);
-        percent = glm::clamp(percent, -1.0f, 1.0f);
-        glm::vec2 oldVelocity = ball->Attr()->velocity;
-        ball->Attr()->velocity.x = BALL_VELOCITY.x * percent * 2.0f;
-        ball->Attr()->velocity =
-            glm::normalize(ball->Attr()->velocity) *
-            glm::length(oldVelocity);
-        ball->Attr()->velocity.y = -1.0f *
-            std::fabs(ball->Attr()->velocity.y);
-        if (ball->Attr()->isSticky) {
-            objects.erase(ball.get());
-            player->children.insert(ball.get());
-            ball->Attr()->isStatic = true;
-        }
-        soundEngine->play2D(
-            ResourceManager::GetInstance()
-                ->RelativePathToAbolutePath("resources/audio/bleep.wav")
-                .c_str(),
-            false);
-    }
-
-    // Power up VS Player
-    for (auto &p : powerUps) {
-        if (p->Attr()->isDestroyed) {
-            continue;
-        }
-        if (p->Attr()->position.y >= Height) {
-            p->Attr()->isDestroyed = true;
-            continue;
-        }
-        if (checkCollision(player.get(), p.get())) {
-            activatePowerUp(p.get());
-            p->Attr()->isDestroyed = true;
-            p->Attr()->isActive = true;
-            soundEngine->play2D(
-                ResourceManager::GetInstance()
-                    ->RelativePathToAbolutePath("resources/audio/powerup.wav")
-                    .c_str(),
-                false);
-        }
-    }
-}
-
-bool Game::checkCollision(const GameObject* obj1,
-                          const GameObject* obj2) const {
-    bool collisionX =
-        obj1->Attr()->position.x + obj1->Attr()->size.x >=
-        obj2->Attr()->position.x &&
-        obj2->Attr()->position.x + obj2->Attr()->size.x >=
-        obj1->Attr()->position.x;
-    bool collisionY =
-        obj1->Attr()->position.y + obj1->Attr()->size.y >=
-        obj2->Attr()->position.y &&
-        obj2->Attr()->position.y + obj2->Attr()->size.y >=
-        obj1->Attr()->position.y;
-    return collisionX && collisionY;
-}
 
-CollisionInfo
-Game::checkCollision(const Ball* ball,
-                     const GameObject* brick) {
-    glm::vec2 ballCenter = ball->Attr()->position +
-        glm::vec2(ball->Attr()->radius);
-    glm::vec2 halfSize = brick->Attr()->size * 0.5f;
-    glm::vec2 brickCenter = brick->Attr()->position + halfSize;
-    glm::vec2 dist = ballCenter - brickCenter;
-    glm::vec2 closest = glm::clamp(dist, -halfSize, halfSize) +
-        brickCenter;
-
-    dist = closest - ballCenter;
-
-    CollisionInfo info;
-    info.isCollided = glm::length(dist) < ball->Attr()->radius;
-    info.direction= info.isCollided ?
-        calculateCollisionDirection(dist) :
-        glm::vec2(1.0f);
-    info.displace = dist;
-
-    return info;
-}
-
-glm::vec2
-Game::calculateCollisionDirection(const glm::vec2& dir) {
-    static glm::vec2 compass[] = {
-        glm::vec2(0.0f, 1.0f),
-        glm::vec2(1.0f, 0.0f),
-        glm::vec2(0.0f, -1.0f),
-        glm::vec2(-1.0f, 0.0f),
+    // Everything drawn through the sprite batches shares one texture
+    ResourceManager::GetInstance()->LoadTextureAtlas("sprites", {
+            { "resources/textures/awesomeface.png", "face", true },
+            { "resources/textures/block.png", "brick" },
+            { "resources/textures/block_solid.png", "brick_solid" },
+            { "resources/textures/paddle.png", "paddle" },
+            { "resources/textures/powerup_chaos.png", "chaos" },
+            { "resources/textures/powerup_confuse.png", "confuse" },
+            { "resources/textures/powerup_increase.png",
+              "pad-size-increase" },
+            { "resources/textures/powerup_passthrough.png",
+              "pass-through" },
+            { "resources/textures/powerup_speed.png", "speed" },
+            { "resources/textures/powerup_sticky.png", "sticky" },
+        }, SPRITE_ATLAS_WIDTH);
+
+    static const std::pair<Sprite, const char*> spriteNames[] = {
+        { Sprite::Paddle, "paddle" },
+        { Sprite::Face, "face" },
+        { Sprite::Brick, "brick" },
+        { Sprite::BrickSolid, "brick_solid" },
+        { Sprite::PowerUpSpeed, "speed" },
+        { Sprite::PowerUpSticky, "sticky" },
+        { Sprite::PowerUpPassThrough, "pass-through" },
+        { Sprite::PowerUpPadSizeIncrease, "pad-size-increase" },
+        { Sprite::PowerUpConfuse, "confuse" },
+        { Sprite::PowerUpChaos, "chaos" },
+        { Sprite::PowerUpSplit, "face" },
     };
-    float max = 0.0f;
-    int best = -1;
-    for (int i = 0; i < 4; ++i) {
-        float dotProduct = glm::dot(glm::normalize(compass[i]), dir);
-        if (dotProduct > max) {
-            max = dotProduct;
-            best = i;
-        }
-    }
-    return compass[best];
-}
-
-void Game::applyCollision(Ball* ball, const CollisionInfo& info) {
-    if (info.direction == glm::vec2(1.0f, 0.0f) ||
-        info.direction == glm::vec2(-1.0f, 0.0f)) {
-        ball->Attr()->velocity.x *= -1.0f;
-        float penetration = ball->Attr()->radius -
-            std::fabs(info.displace.x);
-        ball->Attr()->position.x += info.direction.x == 1.0f ?
-            -penetration : +penetration;
-    } else {
-        ball->Attr()->velocity.y *= -1.0f;
-        float penetration = ball->Attr()->radius -
-            std::fabs(info.displace.y);
-        ball->Attr()->position.y += info.direction.y == 1.0f ?
-            -penetration : penetration;
+    for (const auto& [sprite, name] : spriteNames) {
+        const TextureRegion* region =
+            ResourceManager::GetInstance()->GetTextureRegion(name);
+        assert(region);
+        sprites[(int)sprite] = *region;
     }
-}
-
-bool Game::shouldSpawn(int chance) const {
-    int random = rand() % chance;
-    return random == 0;
-}
 
-void Game::spawnPowerUps(const GameObject* object) {
-    PowerUpAttribute puAttr;
-    puAttr.size = glm::vec2(60.0f, 20.0f);
-    puAttr.velocity = glm::vec2(0.0f, 150.0f);
-    puAttr.position = object->Attr()->position;
-    puAttr.endCallback = [=](const PowerUp* p) ->void {
-        this->onPowerUpEnd(p);
+    static const char* levelFiles[] = {
+        "resources/levels/one.lvl",
+        "resources/levels/two.lvl",
+        "resources/levels/three.lvl",
+        "resources/levels/four.lvl",
     };
-    if (shouldSpawn(75)) {
-        puAttr.type = "speed";
-        puAttr.color = glm::vec3(0.5f, 0.5f, 1.0f);
-        puAttr.duration = 0.0f;
-        puAttr.texture = ResourceManager::GetInstance()->
-            GetTexture2D(puAttr.type);
-        powerUps.push_back(std::make_unique<PowerUp>(puAttr));
+    for (const char* file : levelFiles) {
+        sim.LoadLevel(ResourceManager::GetInstance()->
+                      RelativePathToAbolutePath(file));
     }
-    if (shouldSpawn(75)) {
-        puAttr.type = "sticky";
-        puAttr.color = glm::vec3(1.0f, 0.5f, 1.0f);
-        puAttr.duration = 20.0f;
-        puAttr.texture = ResourceManager::GetInstance()->
-            GetTexture2D(puAttr.type);
-        powerUps.push_back(std::make_unique<PowerUp>(puAttr));
-    }
-    if (shouldSpawn(75)) {
-        puAttr.type = "pass-through";
-        puAttr.color = glm::vec3(0.5f, 1.0f, 0.5f);
-        puAttr.duration = 10.0f;
-        puAttr.texture = ResourceManager::GetInstance()->
-            GetTexture2D(puAttr.type);
-        powerUps.push_back(std::make_unique<PowerUp>(puAttr));
-    }
-    if (shouldSpawn(75)) {
-        puAttr.type = "pad-size-increase";
-        puAttr.color = glm::vec3(1.0f, 0.6f, 0.4f);
-        puAttr.duration = 0.0f;
-        puAttr.texture = ResourceManager::GetInstance()->
-            GetTexture2D(puAttr.type);
-        powerUps.push_back(std::make_unique<PowerUp>(puAttr));
-    }
-    if (shouldSpawn(15)) {
-        puAttr.type = "confuse";
-        puAttr.color = glm::vec3(1.0f, 0.3f, 0.3f);
-        puAttr.duration = 3.0f;
-        puAttr.texture = ResourceManager::GetInstance()->
-            GetTexture2D(puAttr.type);
-        powerUps.push_back(std::make_unique<PowerUp>(puAttr));
-    }
-    if (shouldSpawn(15)) {
-        puAttr.type = "chaos";
-        puAttr.color = glm::vec3(0.9f, 0.25f, 0.25f);
-        puAttr.duration = 3.0f;
-        puAttr.texture = ResourceManager::GetInstance()->
-            GetTexture2D(puAttr.type);
-        powerUps.push_back(std::make_unique<PowerUp>(puAttr));
-    }
-}
-
-void Game::activatePowerUp(const PowerUp* p) {
-    if (p->Attr()->type == "speed") {
-        ball->Attr()->velocity *= 1.2;
-    } else if (p->Attr()->type == "sticky") {
-        ball->Attr()->isSticky = true;
-        player->Attr()->color = glm::vec3(1.0f, 0.5f, 1.0f);
-    } else if (p->Attr()->type == "pass-through") {
-        ball->Attr()->isPassThrough = true;
-        ball->Attr()->color = glm::vec3(1.0f, 0.5f, 0.5f);
-    } else if (p->Attr()->type == "pad-size-increase") {
-        player->Attr()->size.x += 50;
-    } else if (p->Attr()->type == "confuse") {
-        if (!effects->chaos) {
-            effects->confuse = true;
-        }
-    } else if (p->Attr()->type == "chaos") {
-        if (!effects->confuse) {
-            effects->chaos = true;
-        }
-    }
-}
-
-void Game::updatePowerUps(float dt) {
-    for (auto& p : powerUps) {
-        p->Update(dt);
-    }
-    powerUps.erase(
-        std::remove_if(
-            powerUps.begin(), powerUps.end(),
-            [] (const std::unique_ptr<PowerUp>& p) {
-                return p->Attr()->isDestroyed &&
-                    !p->Attr()->isActive;
-            }),
-        powerUps.end());
-}
-
-bool Game::otherActivePowerUp(const std::string& type) {
-    for (const auto& p : powerUps) {
-        if (p->Attr()->isActive && p->Attr()->type == type) {
-            return true;
-        }
-    }
-    return false;
-}
-
-void Game::onPowerUpEnd(const PowerUp* p) {
-    const auto& type = p->Attr()->type;
-    if (type == "sticky") {
-        ball->Attr()->isSticky = false;
-        player->Attr()->color = glm::vec3(1.0f);
-    } else if (type == "pass-through") {
-        ball->Attr()->isPassThrough = false;
-        ball->Attr()->color = glm::vec3(1.0f);
-    } else if (type == "confuse") {
-        if (!otherActivePowerUp("confuse")) {
-            effects->confuse = false;
-        }
-    } else if (type == "chaos") {
-        if (!otherActivePowerUp("chaos")) {
-            effects->chaos = false;
-        }
-    }
-}
-
-void Game::reset_player() {
-    player->Attr()->size = PLAYER_SIZE;
-    player->Attr()->position = glm::vec2(
-        Width / 2.0f - player->Attr()->size.x / 2.0f,
-        Height  - player->Attr()->size.y
-        );
-}
-
-void Game::reset_ball() {
-    ball->Attr()->velocity = BALL_VELOCITY;
-    ball->Attr()->position = glm::vec2(
-        player->Attr()->position.x + player->Attr()->size.x / 2.0f -
-        ball->Attr()->size.x / 2.0f,
-        player->Attr()->position.y - ball->Attr()->size.y
-        );
-    ball->Attr()->isStatic = true;
-}
-
-void Game::clear_powerups() {
-    for (auto& p : powerUps) {
-        onPowerUpEnd(p.get());
-    }
-    powerUps.clear();
-}
-
-void Game::reset_level() {
-    levels[level]->Reset();
 }
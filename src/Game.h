@@ -3,89 +3,124 @@
 
 #include <vector>
 #include <memory>
-#include <unordered_set>
+#include <string>
 
 #include <glm/gtc/type_ptr.hpp>
 
-class GameLevel;
-class Ball;
+#include "sim/SimSnapshot.h"
+#include "sim/Simulation.h"
+#include "sim/Sprite.h"
+#include "TextureAtlas.h"
+
 class GameObject;
-class PowerUp;
+class Texture2D;
 class TextRenderer;
 class SpriteRenderer;
 class PostProcessor;
 class ParticleGenerator;
-
-enum class GameState {
-    GAME_ACTIVE,
-    GAME_MENU,
-    GAME_WIN,
-};
-
-struct CollisionInfo {
-    bool isCollided;
-    glm::vec2 direction;
-    glm::vec2 displace;
+class ReplayWriter;
+class ReplayReader;
+
+// Range of Game::SetTimeScale
+const float MIN_TIME_SCALE = 0.25f;
+const float MAX_TIME_SCALE = 64.0f;
+
+// The simulation state plus the screen shake, which the frontend keeps
+// track of itself
+struct GameSnapshot {
+    SimSnapshot sim;
+    float shakeTime;
+    bool shake;
 };
 
+// Window frontend of the game: feeds keyboard state into the
+// Simulation, turns its events into sounds and screen effects and
+// renders its state.
 class Game{
 public:
     Game(int width, int height);
     ~Game();
     void Init();
+    // Samples the keyboard, the result is fed to the next Update
     void ProcessInput(float dt);
+    // Advances the game by one simulation step
     void Update(float dt);
-    void Render();
+    // Reacts to the events of all steps since the last call, once per
+    // frame after the steps
+    void HandleEvents();
+    // alpha interpolates moving objects between the previous and the
+    // current simulation step, 1.0 draws the current state
+    void Render(float alpha = 1.0f);
+
+    Simulation& GetSimulation() { return sim; }
+
+    // Game seconds per real second, clamped to [MIN_TIME_SCALE,
+    // MAX_TIME_SCALE]. The main loop feeds the scaled time into the
+    // fixed timestep, so the steps and their outcome stay the same.
+    void SetTimeScale(float scale);
+    float GetTimeScale() const { return timeScale; }
+    // Runs steps as fast as the CPU allows and renders only once in a
+    // while, for soak tests and measuring throughput. Sounds are
+    // skipped meanwhile.
+    void SetFastForward(bool fastForward) { this->fastForward = fastForward; }
+    bool IsFastForward() const { return fastForward; }
+
+    // Writes the input and length of every step from now on, call
+    // before the first Update
+    bool StartRecording(const std::string& path);
+    void StopRecording();
+    // Plays a recording instead of the keyboard, call before the first
+    // Update. The keyboard takes over when it ends.
+    bool StartReplay(const std::string& path);
+
+    // See Simulation::Capture and Restore. Restoring stops recording and
+    // replaying, the recording could not be played back any more.
+    bool Capture(GameSnapshot& snapshot) const;
+    bool Restore(const GameSnapshot& snapshot);
+    // F6 writes the game to this file, see SaveState.h
+    void SetSavePath(const std::string& path) { savePath = path; }
+    // Size of the particle pool of the ball's trail, call before Init
+    void SetParticleCount(int count) { particleCount = count; }
 
-    GameState State = GameState::GAME_MENU;
     bool Keys[1024] = {0};
     bool Processed[1024] = {0};
     int Width, Height;
 
 private:
 
-    int play_ball = 2;
-    int level = 0;
-
-    // Objects
-    std::vector<std::unique_ptr<GameObject>> boundary;
-    std::vector<std::unique_ptr<GameLevel>> levels;
-    std::vector<std::unique_ptr<PowerUp>> powerUps;
-    std::unique_ptr<GameObject> player;
-    std::unique_ptr<Ball> ball;
-    std::unordered_set<GameObject*> objects;
+    Simulation sim;
+    InputState input;
+    float shakeTime = 0.0f;
+    float timeScale = 1.0f;
+    bool fastForward = false;
+    std::unique_ptr<ReplayWriter> recorder;
+    std::unique_ptr<ReplayReader> replay;
+    // F5 saves, F9 goes back to it
+    GameSnapshot quickSave;
+    bool hasQuickSave = false;
+    std::string savePath = "breakout.sav";
+    int particleCount = 500;
 
     // Rendering
     std::unique_ptr<PostProcessor> effects;
     std::unique_ptr<SpriteRenderer> sprite_renderer;
     std::unique_ptr<TextRenderer> text_renderer;
     std::unique_ptr<ParticleGenerator> particles;
+    TextureRegion sprites[(int)Sprite::Count];
 
-    // PowerUp
-    bool shouldSpawn(int chance) const;
-    void spawnPowerUps(const GameObject* brick);
-    void updatePowerUps(float dt);
-    void activatePowerUp(const PowerUp* p);
-    bool otherActivePowerUp(const std::string& type);
-    void onPowerUpEnd(const PowerUp* p);
+    // Input
+    bool consumeKey(int key);
 
     // Resources
     void loadResources();
 
-    // Collision
-    void doCollision();
-    bool checkCollision(const GameObject* obj1,
-                        const GameObject* obj2) const;
-    CollisionInfo checkCollision(const Ball* ball,
-                                 const GameObject* brick);
-    glm::vec2 calculateCollisionDirection(const glm::vec2& dir);
-    void applyCollision(Ball* ball, const CollisionInfo& info);
-
-    // Game Logic
-    void reset_player();
-    void reset_ball();
-    void reset_level();
-    void clear_powerups();
+    // Events of the steps run since the last HandleEvents, only their
+    // counts are needed
+    SimEventCounts frameEvents;
+
+    void drawObject(const GameObject* object, float alpha = 1.0f);
+    void drawEntity(const EntityStore& store, EntityStore::Index i,
+                    float alpha = 1.0f);
 };
 
 #endif
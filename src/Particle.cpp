@@ -1,9 +1,10 @@
 #include "Particle.h"
 
-#include <random>
+#include <cstddef>
 
+#include "GLState.h"
 #include "Shader.h"
-#include "GameObject.h"
+#include "sim/GameObject.h"
 #include "Utility.h"
 
 const float ParticleGenerator::particleQuad[] = {
@@ -19,17 +20,20 @@ const float ParticleGenerator::particleQuad[] = {
 ParticleGenerator::
 ParticleGenerator(int number, const Shader* shader,
                   const Texture2D* texture)
-    : number(number)
-    , shader(shader)
+    : shader(shader)
+    , spriteUniform(shader->GetUniform<Sampler>("sprite"))
     , texture(texture)
+    , number(number)
     , particles(number) {
+    instances.reserve(number);
     init();
 }
 
 ParticleGenerator::
 ~ParticleGenerator() {
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
+    GLState::GetInstance()->DeleteVertexArray(VAO);
+    GLState::GetInstance()->DeleteBuffer(VBO);
+    GLState::GetInstance()->DeleteBuffer(instanceVBO);
 }
 
 void
@@ -51,38 +55,50 @@ Update(float dt, const GameObject* object,
 }
 
 void ParticleGenerator::Draw() {
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-    shader->use();
+    instances.clear();
     for (auto& p : particles) {
         if (p.life > 0.0f) {
-            shader->setVec2("offset", p.position);
-            shader->setVec4("color", p.color);
-            shader->setTexture("sprite", 0, texture);
-            glBindVertexArray(VAO);
-            glDrawArrays(GL_TRIANGLES, 0, 6);
-            glBindVertexArray(0);
+            instances.push_back({ p.position, p.color });
         }
     }
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    if (instances.empty()) {
+        return;
+    }
+
+    GLState* state = GLState::GetInstance();
+    state->StreamArrayBuffer(instanceVBO,
+                             number * sizeof(ParticleInstance),
+                             instances.data(),
+                             instances.size() * sizeof(ParticleInstance));
+
+    state->BlendFunc(GL_SRC_ALPHA, GL_ONE);
+    shader->use();
+    shader->set(spriteUniform, 0, texture);
+    state->BindVertexArray(VAO);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, (GLsizei)instances.size());
+    state->BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+void ParticleGenerator::Seed(std::uint64_t seed) {
+    random.Seed(seed, RandomStream::Cosmetic);
 }
 
-int ParticleGenerator::getNextParticle() const {
-    static int idx = 0;
-    for (int i = idx; i < particles.size(); ++i) {
+int ParticleGenerator::getNextParticle() {
+    for (int i = nextParticle; i < particles.size(); ++i) {
         if (particles[i].life <= 0.0f) {
-            idx = i + 1;
+            nextParticle = i + 1;
             return i;
         }
     }
 
     for (int i = 0; i < particles.size(); ++i) {
         if (particles[i].life <= 0.0f) {
-            idx = i + 1;
+            nextParticle = i + 1;
             return i;
         }
     }
 
-    idx = 1;
+    nextParticle = 1;
     return 0;
 }
 
@@ -90,25 +106,41 @@ void ParticleGenerator::respawnParticle(
     Particle& p,
     const GameObject* object,
     const glm::vec2& offset) {
-    float random = ((rand() % 100) - 50) / 10.0f;
-    float color = 0.5f + ((rand() % 100) / 100.0f);
-    p.position = object->Attr()->position +
-        glm::vec2(random) + offset;
+    float jitter = ((int)random.Below(100) - 50) / 10.0f;
+    float color = 0.5f + (random.Below(100) / 100.0f);
+    p.position = object->Position() +
+        glm::vec2(jitter) + offset;
     p.color = glm::vec4(glm::vec3(color), 1.0f);
     p.life = 1.0f;
-    p.velocity = object->Attr()->velocity * 0.1f;
+    p.velocity = object->Velocity() * 0.1f;
 }
 
 void ParticleGenerator::init() {
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    GLState::GetInstance()->BindVertexArray(VAO);
+    GLState::GetInstance()->BindArrayBuffer(VBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(particleQuad),
                  particleQuad, GL_STATIC_DRAW);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE,
                           4 * sizeof(float), (void*)0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+
+    // Every instance advances these by one particle
+    glGenBuffers(1, &instanceVBO);
+    GLState::GetInstance()->BindArrayBuffer(instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, number * sizeof(ParticleInstance),
+                 nullptr, GL_STREAM_DRAW);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE,
+                          sizeof(ParticleInstance),
+                          (void*)offsetof(ParticleInstance, position));
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE,
+                          sizeof(ParticleInstance),
+                          (void*)offsetof(ParticleInstance, color));
+    glVertexAttribDivisor(2, 1);
+    GLState::GetInstance()->BindArrayBuffer(0);
+    GLState::GetInstance()->BindVertexArray(0);
 }
@@ -7,7 +7,9 @@
 #include <glad/glad.h>
 #include <glm/gtc/type_ptr.hpp>
 
-class Shader;
+#include "sim/Random.h"
+#include "Shader.h"
+
 class Texture2D;
 class GameObject;
 
@@ -22,6 +24,12 @@ struct Particle {
         , life(0.0f) { }
 };
 
+// Per-instance data of a live particle, as particle.vert reads it
+struct ParticleInstance {
+    glm::vec2 position;
+    glm::vec4 color;
+};
+
 class ParticleGenerator {
 public:
 
@@ -33,18 +41,28 @@ public:
                 int newParticles,
                 const glm::vec2& offset = glm::vec2(0.0f));
     void Draw();
+    // Particles roll from their own cosmetic stream, they never change
+    // what the simulation rolls
+    void Seed(std::uint64_t seed);
 
 private:
 
     const Shader* shader;
+    Uniform<Sampler> spriteUniform;
     const Texture2D* texture;
     GLuint VAO;
     GLuint VBO;
+    // Live particles of the frame, drawn with one instanced call
+    GLuint instanceVBO;
     const int number;
     std::vector<Particle> particles;
+    std::vector<ParticleInstance> instances;
+    Random random{ 1, RandomStream::Cosmetic };
+    // Where the search for a dead particle starts
+    int nextParticle = 0;
 
     void init();
-    int getNextParticle() const;
+    int getNextParticle();
     void respawnParticle(Particle& p,
                          const GameObject* object,
                          const glm::vec2& offset = glm::vec2(0.0f));
@@ -2,6 +2,7 @@
 
 #include <fmt/core.h>
 
+#include "GLState.h"
 #include "Texture2D.h"
 #include "Shader.h"
 
@@ -44,12 +45,17 @@ PostProcessor::PostProcessor(const Shader* shader,
                              int width, int height)
     : shader(shader)
     , width(width)
-    , height(height) {
+    , height(height)
+    , timeUniform(shader->GetUniform<float>("time"))
+    , confuseUniform(shader->GetUniform<bool>("confuse"))
+    , chaosUniform(shader->GetUniform<bool>("chaos"))
+    , shakeUniform(shader->GetUniform<bool>("shake"))
+    , sceneUniform(shader->GetUniform<Sampler>("scene")) {
     glGenFramebuffers(1, &MSFBO);
     glGenFramebuffers(1, &FBO);
     glGenRenderbuffers(1, &RBO);
 
-    glBindFramebuffer(GL_FRAMEBUFFER, MSFBO);
+    GLState::GetInstance()->BindFramebuffer(GL_FRAMEBUFFER, MSFBO);
     glBindRenderbuffer(GL_RENDERBUFFER, RBO);
     glRenderbufferStorageMultisample(GL_RENDERBUFFER, 4, GL_RGB,
                                      width, height);
@@ -61,7 +67,7 @@ PostProcessor::PostProcessor(const Shader* shader,
                    "Failed to initialize MSFBO\n");
     }
 
-    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+    GLState::GetInstance()->BindFramebuffer(GL_FRAMEBUFFER, FBO);
     TextureSource ts;
     ts.width = width;
     ts.height = height;
@@ -74,7 +80,7 @@ PostProcessor::PostProcessor(const Shader* shader,
                    "Failed to initialize FBO\n");
     }
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GLState::GetInstance()->BindFramebuffer(GL_FRAMEBUFFER, 0);
 
     initData();
 
@@ -85,50 +91,49 @@ PostProcessor::PostProcessor(const Shader* shader,
 }
 
 PostProcessor::~PostProcessor() {
-    glDeleteBuffers(1, &VBO);
-    glDeleteVertexArrays(1, &VAO);
+    GLState::GetInstance()->DeleteBuffer(VBO);
+    GLState::GetInstance()->DeleteVertexArray(VAO);
 }
 
 void PostProcessor::initData() {
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    GLState::GetInstance()->BindArrayBuffer(VBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices),
                  vertices, GL_STATIC_DRAW);
 
-    glBindVertexArray(VAO);
+    GLState::GetInstance()->BindVertexArray(VAO);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE,
                           4 * sizeof(float), (void*)0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    GLState::GetInstance()->BindArrayBuffer(0);
+    GLState::GetInstance()->BindVertexArray(0);
 }
 
 void PostProcessor::BeginRender() {
-    glBindFramebuffer(GL_FRAMEBUFFER, MSFBO);
+    GLState::GetInstance()->BindFramebuffer(GL_FRAMEBUFFER, MSFBO);
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
 }
 
 void PostProcessor::EndRender() {
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, MSFBO);
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, FBO);
+    GLState::GetInstance()->BindFramebuffer(GL_READ_FRAMEBUFFER, MSFBO);
+    GLState::GetInstance()->BindFramebuffer(GL_DRAW_FRAMEBUFFER, FBO);
     glBlitFramebuffer(0, 0, width, height,
                       0, 0, width, height,
                       GL_COLOR_BUFFER_BIT, GL_NEAREST);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GLState::GetInstance()->BindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 void PostProcessor::Render(float time) {
     shader->use();
-    shader->setFloat("time", time);
-    shader->setInt("confuse", confuse);
-    shader->setInt("chaos", chaos);
-    shader->setInt("shake", shake);
+    shader->set(timeUniform, time);
+    shader->set(confuseUniform, confuse);
+    shader->set(chaosUniform, chaos);
+    shader->set(shakeUniform, shake);
 
-    shader->setTexture("scene", 0, texture.get());
-    glBindVertexArray(VAO);
+    shader->set(sceneUniform, 0, texture.get());
+    GLState::GetInstance()->BindVertexArray(VAO);
     glDrawArrays(GL_TRIANGLES, 0, 6);
-    glBindVertexArray(0);
 }
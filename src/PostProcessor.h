@@ -5,9 +5,9 @@
 
 #include <glad/glad.h>
 
+#include "Shader.h"
 #include "Texture2D.h"
 
-class Shader;
 class Texture2D;
 
 class PostProcessor {
@@ -31,6 +31,12 @@ public:
 
 private:
 
+    Uniform<float> timeUniform;
+    Uniform<bool> confuseUniform;
+    Uniform<bool> chaosUniform;
+    Uniform<bool> shakeUniform;
+    Uniform<Sampler> sceneUniform;
+
     GLuint MSFBO = 0;
     GLuint FBO = 0;
     GLuint RBO = 0;
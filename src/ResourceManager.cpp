@@ -4,11 +4,13 @@
 #include <sstream>
 #include <cassert>
 #include <filesystem>
+#include <cmath>
 
 #include <fmt/core.h>
 #include "stb_image.h"
 #include <glad/glad.h>
 
+#include "FrameArena.h"
 #include "Shader.h"
 #include "Texture2D.h"
 
@@ -136,6 +138,65 @@ LoadTexture2D(const char* path, const std::string& name,
     return textures[name].get();
 }
 
+TextureAtlas*
+ResourceManager::LoadTextureAtlas(const std::string& name,
+                                  const std::vector<AtlasImage>& images,
+                                  int width) {
+    // The atlas is plain RGBA, images meant to be sampled as sRGB are
+    // converted to linear up front
+    unsigned char toLinear[256];
+    for (int i = 0; i < 256; ++i) {
+        float c = i / 255.0f;
+        c = c <= 0.04045f ? c / 12.92f :
+            std::pow((c + 0.055f) / 1.055f, 2.4f);
+        toLinear[i] = (unsigned char)std::lround(c * 255.0f);
+    }
+
+    auto atlas = std::make_unique<TextureAtlas>();
+    for (const auto& image : images) {
+        int imageWidth, imageHeight, channels;
+        std::string texturePath = projectRootDir + "/" + image.path;
+        unsigned char* data = stbi_load(texturePath.c_str(), &imageWidth,
+                                        &imageHeight, &channels, 4);
+        if (!data) {
+            fmt::print("Failed to load texture {}!\n", texturePath);
+            return nullptr;
+        }
+        if (image.gammaCorrection) {
+            for (int i = 0; i < imageWidth * imageHeight * 4; ++i) {
+                // Alpha is linear already
+                if (i % 4 != 3) {
+                    data[i] = toLinear[data[i]];
+                }
+            }
+        }
+        atlas->Add(image.name, data, imageWidth, imageHeight);
+        stbi_image_free(data);
+    }
+    if (!atlas->Build(width)) {
+        return nullptr;
+    }
+
+    atlases[name] = std::move(atlas);
+    return atlases[name].get();
+}
+
+TextureAtlas*
+ResourceManager::GetTextureAtlas(const std::string& name) {
+    auto it = atlases.find(name);
+    return it == atlases.end() ? nullptr : it->second.get();
+}
+
+const TextureRegion*
+ResourceManager::GetTextureRegion(const std::string& name) {
+    for (const auto& [atlasName, atlas] : atlases) {
+        if (auto region = atlas->GetRegion(name)) {
+            return region;
+        }
+    }
+    return nullptr;
+}
+
 std::string ResourceManager::LoadShaderCode(const char* file) {
     std::ifstream fstream;
     std::stringstream content;
@@ -175,3 +236,9 @@ void ResourceManager::OpenFile(const char* path, std::ifstream& fstream) {
 std::string ResourceManager::RelativePathToAbolutePath(const std::string& relativePath) {
   return projectRootDir + "/" + relativePath;
 }
+
+const char* ResourceManager::FrameAbsolutePath(std::string_view relativePath) {
+  return FrameArena::GetInstance()
+      ->Concat({projectRootDir, "/", relativePath})
+      .data();
+}
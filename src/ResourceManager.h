@@ -3,13 +3,23 @@
 
 #include <unordered_map>
 #include <string>
+#include <string_view>
 #include <memory>
+#include <vector>
 
 #include "Texture2D.h"
+#include "TextureAtlas.h"
 
 class Texture2D;
 class Shader;
 
+// An image packed into an atlas by LoadTextureAtlas, looked up by name
+struct AtlasImage {
+    const char* path;
+    const char* name;
+    bool gammaCorrection = false;
+};
+
 class ResourceManager {
 public:
 
@@ -30,9 +40,25 @@ public:
     Texture2D*
     GetTexture2D(const std::string& name);
 
+    // Packs the images into one texture width texels wide, see
+    // TextureAtlas
+    TextureAtlas*
+    LoadTextureAtlas(const std::string& name,
+                     const std::vector<AtlasImage>& images, int width);
+
+    TextureAtlas*
+    GetTextureAtlas(const std::string& name);
+
+    // Where an image of any loaded atlas ended up, null if none has it
+    const TextureRegion*
+    GetTextureRegion(const std::string& name);
+
   void OpenFile(const char* path, std::ifstream& fstream);
 
   std::string RelativePathToAbolutePath(const std::string& relativePath);
+  // Same as above but the result lives in the frame arena, so it is only
+  // valid until the end of the current frame.
+  const char* FrameAbsolutePath(std::string_view relativePath);
 
 private:
 
@@ -44,6 +70,8 @@ private:
                        std::unique_ptr<Shader>> shaders;
     std::unordered_map<std::string,
                        std::unique_ptr<Texture2D>> textures;
+    std::unordered_map<std::string,
+                       std::unique_ptr<TextureAtlas>> atlases;
   std::string projectRootDir;
 };
 #endif
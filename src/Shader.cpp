@@ -5,6 +5,7 @@
 
 #include <fmt/core.h>
 
+#include "GLState.h"
 #include "Texture2D.h"
 
 const char* ERROR_LOG_FMT = "Shader {} compilation failed!\n{}\n";
@@ -69,72 +70,177 @@ Shader::Shader(ShaderSource* vert, ShaderSource* frag,
         glDetachShader(ID, geometry);
         glDeleteShader(geometry);
     }
+
+    reflectUniforms();
 }
 
 Shader::~Shader() {
-    glDeleteProgram(ID);
+    GLState::GetInstance()->DeleteProgram(ID);
 }
 void Shader::use() const {
-    glUseProgram(ID);
+    GLState::GetInstance()->UseProgram(ID);
 }
 
-void Shader::setBool( const std::string& name, bool value ) const {
-    glUniform1i( glGetUniformLocation( ID, name.c_str() ), ( int )value );
+void Shader::setBool( const char* name, bool value ) const {
+    glUniform1i( location( name ), ( int )value );
 }
 
-void Shader::setInt( const std::string& name, int value ) const {
-    glUniform1i( glGetUniformLocation( ID, name.c_str() ), value );
+void Shader::setInt( const char* name, int value ) const {
+    glUniform1i( location( name ), value );
 }
 
-void Shader::setFloat( const std::string& name, float value ) const {
-    glUniform1f( glGetUniformLocation( ID, name.c_str() ), value );
+void Shader::setFloat( const char* name, float value ) const {
+    glUniform1f( location( name ), value );
 }
 
-void Shader::setMat4( const std::string& name, const glm::mat4& value ) const {
-    glUniformMatrix4fv( glGetUniformLocation( ID, name.c_str() ), 1, GL_FALSE, glm::value_ptr( value ) );
+void Shader::setMat4( const char* name, const glm::mat4& value ) const {
+    glUniformMatrix4fv( location( name ), 1, GL_FALSE, glm::value_ptr( value ) );
 }
 
-void Shader::setVec3( const std::string& name, const glm::vec3& value ) const {
-    glUniform3fv( glGetUniformLocation( ID, name.c_str() ), 1, glm::value_ptr( value ) );
+void Shader::setVec3( const char* name, const glm::vec3& value ) const {
+    glUniform3fv( location( name ), 1, glm::value_ptr( value ) );
 }
 
-void Shader::setVec3( const std::string& name, float x, float y, float z) const {
-    glUniform3f( glGetUniformLocation( ID, name.c_str() ), x, y, z );
+void Shader::setVec3( const char* name, float x, float y, float z) const {
+    glUniform3f( location( name ), x, y, z );
 }
 
-void Shader::setTexture(const std::string& name, int value,
+void Shader::setTexture(const char* name, int value,
                         const Texture2D* tex) const {
-    glActiveTexture(GL_TEXTURE0 + value);
-    glBindTexture(GL_TEXTURE_2D, tex->ID);
+    GLState::GetInstance()->BindTexture(value, tex->ID);
     setInt(name, value);
 }
 
-void Shader::setVec2(const std::string& name,
+void Shader::setVec2(const char* name,
                      const glm::vec2& value) const {
-    glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1,
+    glUniform2fv(location(name), 1,
                  glm::value_ptr(value));
 }
 
-void Shader::setVec4(const std::string& name,
+void Shader::setVec4(const char* name,
                      const glm::vec4& value) const {
-    glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1,
+    glUniform4fv(location(name), 1,
                  glm::value_ptr(value));
 }
 
-void Shader::setFloatV(const std::string& name,
+void Shader::setFloatV(const char* name,
                        const float* values, int num) const {
-    glUniform1fv(glGetUniformLocation(ID, name.c_str()), num,
+    glUniform1fv(location(name), num,
                  values);
 }
 
-void Shader::setVec2V(const std::string& name,
+void Shader::setVec2V(const char* name,
                       const float* values, int num) const {
-    glUniform2fv(glGetUniformLocation(ID, name.c_str()), num,
+    glUniform2fv(location(name), num,
                  values);
 }
 
-void Shader::setIntV(const std::string& name,
+void Shader::setIntV(const char* name,
                      const int* values, int num) const {
-    glUniform1iv(glGetUniformLocation(ID, name.c_str()), num,
+    glUniform1iv(location(name), num,
                  values);
 }
+
+void Shader::reflectUniforms() {
+    GLint count = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+    uniforms.reserve(count);
+    for (GLint i = 0; i < count; ++i) {
+        char name[256];
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(ID, i, sizeof(name), &length, &size, &type,
+                           name);
+        // Arrays are reported as their first element
+        std::string uniformName(name, length);
+        if (size > 1 && uniformName.size() > 3 &&
+            uniformName.compare(uniformName.size() - 3, 3, "[0]") == 0) {
+            uniformName.resize(uniformName.size() - 3);
+        }
+        uniforms.push_back({ std::move(uniformName),
+                             glGetUniformLocation(ID, name), type });
+    }
+}
+
+const Shader::UniformInfo* Shader::findUniformInfo(const char* name) const {
+    for (const auto& uniform : uniforms) {
+        if (uniform.name == name) {
+            return &uniform;
+        }
+    }
+    return nullptr;
+}
+
+GLint Shader::location(const char* name) const {
+    auto uniform = findUniformInfo(name);
+    return uniform ? uniform->location : -1;
+}
+
+GLint Shader::findUniform(const char* name, GLenum type) const {
+    auto uniform = findUniformInfo(name);
+    if (!uniform) {
+        fmt::print("Shader {} has no uniform {}\n", ID, name);
+        return -1;
+    }
+    if (uniform->type != type) {
+        fmt::print("Uniform {} of shader {} has type {:#x}, not {:#x}\n",
+                   name, ID, uniform->type, type);
+        return -1;
+    }
+    return uniform->location;
+}
+
+void Shader::set(Uniform<bool> uniform, bool value) const {
+    glUniform1i(uniform.location, (int)value);
+}
+
+void Shader::set(Uniform<int> uniform, int value) const {
+    glUniform1i(uniform.location, value);
+}
+
+void Shader::set(Uniform<float> uniform, float value) const {
+    glUniform1f(uniform.location, value);
+}
+
+void Shader::set(Uniform<glm::vec2> uniform,
+                 const glm::vec2& value) const {
+    glUniform2fv(uniform.location, 1, glm::value_ptr(value));
+}
+
+void Shader::set(Uniform<glm::vec3> uniform,
+                 const glm::vec3& value) const {
+    glUniform3fv(uniform.location, 1, glm::value_ptr(value));
+}
+
+void Shader::set(Uniform<glm::vec4> uniform,
+                 const glm::vec4& value) const {
+    glUniform4fv(uniform.location, 1, glm::value_ptr(value));
+}
+
+void Shader::set(Uniform<glm::mat4> uniform,
+                 const glm::mat4& value) const {
+    glUniformMatrix4fv(uniform.location, 1, GL_FALSE,
+                       glm::value_ptr(value));
+}
+
+void Shader::set(Uniform<Sampler> uniform, int unit,
+                 const Texture2D* tex) const {
+    GLState::GetInstance()->BindTexture(unit, tex->ID);
+    glUniform1i(uniform.location, unit);
+}
+
+void Shader::set(Uniform<int> uniform,
+                 const int* values, int num) const {
+    glUniform1iv(uniform.location, num, values);
+}
+
+void Shader::set(Uniform<float> uniform,
+                 const float* values, int num) const {
+    glUniform1fv(uniform.location, num, values);
+}
+
+void Shader::set(Uniform<glm::vec2> uniform,
+                 const glm::vec2* values, int num) const {
+    glUniform2fv(uniform.location, num, glm::value_ptr(values[0]));
+}
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 
 #include <glad/glad.h>
 #include <glm/gtc/type_ptr.hpp>
@@ -15,6 +16,39 @@ struct ShaderSource {
     const char* code;
 };
 
+// A sampler uniform, set to a texture unit
+struct Sampler {};
+
+// GL type a uniform must be declared with to be set as T
+template <typename T> struct UniformType;
+template <> struct UniformType<bool> { static const GLenum value = GL_BOOL; };
+template <> struct UniformType<int> { static const GLenum value = GL_INT; };
+template <> struct UniformType<float> { static const GLenum value = GL_FLOAT; };
+template <> struct UniformType<glm::vec2> {
+    static const GLenum value = GL_FLOAT_VEC2;
+};
+template <> struct UniformType<glm::vec3> {
+    static const GLenum value = GL_FLOAT_VEC3;
+};
+template <> struct UniformType<glm::vec4> {
+    static const GLenum value = GL_FLOAT_VEC4;
+};
+template <> struct UniformType<glm::mat4> {
+    static const GLenum value = GL_FLOAT_MAT4;
+};
+template <> struct UniformType<Sampler> {
+    static const GLenum value = GL_SAMPLER_2D;
+};
+
+// Location of a uniform of type T. Found once with Shader::GetUniform,
+// setting it afterwards needs no name lookup. GL ignores the location
+// of an invalid handle.
+template <typename T>
+struct Uniform {
+    GLint location = -1;
+    bool IsValid() const { return location >= 0; }
+};
+
 class Shader {
 public:
     // the program ID
@@ -26,28 +60,66 @@ public:
     ~Shader();
     // use/active the shader
     void use() const;
-    // utility uniform functions
-    void setBool(const std::string& name, bool value) const;
-    void setInt(const std::string& name, int value) const;
-    void setFloat(const std::string& name, float value) const;
-    void setMat4(const std::string& name,
+
+    // Reports a missing uniform or a type other than T, the handle is
+    // invalid then
+    template <typename T>
+    Uniform<T> GetUniform(const char* name) const {
+        return { findUniform(name, UniformType<T>::value) };
+    }
+    // Set the uniform of a handle of this shader, which must be in use
+    void set(Uniform<bool> uniform, bool value) const;
+    void set(Uniform<int> uniform, int value) const;
+    void set(Uniform<float> uniform, float value) const;
+    void set(Uniform<glm::vec2> uniform, const glm::vec2& value) const;
+    void set(Uniform<glm::vec3> uniform, const glm::vec3& value) const;
+    void set(Uniform<glm::vec4> uniform, const glm::vec4& value) const;
+    void set(Uniform<glm::mat4> uniform, const glm::mat4& value) const;
+    void set(Uniform<Sampler> uniform, int unit,
+             const Texture2D* tex) const;
+    // Arrays, from their first element on
+    void set(Uniform<int> uniform, const int* values, int num) const;
+    void set(Uniform<float> uniform, const float* values, int num) const;
+    void set(Uniform<glm::vec2> uniform, const glm::vec2* values,
+             int num) const;
+
+    // Uniforms by name, each call looks the name up. Fine for setting
+    // things up and for tools, the per-frame paths use handles.
+    void setBool(const char* name, bool value) const;
+    void setInt(const char* name, int value) const;
+    void setFloat(const char* name, float value) const;
+    void setMat4(const char* name,
                  const glm::mat4& value) const;
-    void setVec3(const std::string& name,
+    void setVec3(const char* name,
                  const glm::vec3& value) const;
-    void setVec3(const std::string& name,
+    void setVec3(const char* name,
                  float x, float y, float z) const;
-    void setVec2(const std::string& name,
+    void setVec2(const char* name,
                  const glm::vec2& value) const;
-    void setVec4(const std::string& name,
+    void setVec4(const char* name,
                  const glm::vec4& value) const;
-    void setTexture(const std::string& name, int value,
+    void setTexture(const char* name, int value,
                     const Texture2D* tex) const;
-    void setFloatV(const std::string& name,
+    void setFloatV(const char* name,
                    const float* values, int num) const;
-    void setVec2V(const std::string& name,
+    void setVec2V(const char* name,
                   const float* values, int num) const;
-    void setIntV(const std::string& name,
+    void setIntV(const char* name,
                  const int* values, int num) const;
+
+private:
+    // The active uniforms, read once the program is linked
+    struct UniformInfo {
+        std::string name;
+        GLint location;
+        GLenum type;
+    };
+    std::vector<UniformInfo> uniforms;
+
+    void reflectUniforms();
+    const UniformInfo* findUniformInfo(const char* name) const;
+    GLint location(const char* name) const;
+    GLint findUniform(const char* name, GLenum type) const;
 };
 
 #endif
@@ -1,18 +1,34 @@
 #include "SpriteRenderer.h"
 
+#include <algorithm>
+#include <cstddef>
+
+#include "GLState.h"
 #include "Shader.h"
 #include "Utility.h"
 
-SpriteRenderer::SpriteRenderer(const Shader* shader)
+// Sprites the batch has room for before its buffers first grow
+static const std::size_t INITIAL_BATCH_SIZE = 512;
+
+SpriteRenderer::SpriteRenderer(const Shader* shader,
+                               const Shader* batchShader)
     : shader(shader)
+    , batchShader(batchShader)
+    , modelUniform(shader->GetUniform<glm::mat4>("model"))
+    , colorUniform(shader->GetUniform<glm::vec3>("spriteColor"))
+    , imageUniform(shader->GetUniform<Sampler>("image"))
+    , batchImageUniform(batchShader->GetUniform<Sampler>("image"))
     , quadVAO(0)
     , quadVBO(0) {
     InitRenderData();
+    InitBatchData();
 }
 
 SpriteRenderer::~SpriteRenderer() {
-    glDeleteVertexArrays(1, &quadVAO);
-    glDeleteBuffers(1, &quadVBO);
+    GLState::GetInstance()->DeleteVertexArray(quadVAO);
+    GLState::GetInstance()->DeleteBuffer(quadVBO);
+    GLState::GetInstance()->DeleteVertexArray(batchVAO);
+    GLState::GetInstance()->DeleteBuffer(instanceVBO);
 }
 
 void SpriteRenderer::InitRenderData() {
@@ -29,16 +45,56 @@ void SpriteRenderer::InitRenderData() {
     glGenVertexArrays(1, &quadVAO);
     glGenBuffers(1, &quadVBO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    GLState::GetInstance()->BindArrayBuffer(quadVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices,
                  GL_STATIC_DRAW);
 
-    glBindVertexArray(quadVAO);
+    GLState::GetInstance()->BindVertexArray(quadVAO);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE,
+                          4 * sizeof(float), (void*) 0);
+    GLState::GetInstance()->BindArrayBuffer(0);
+    GLState::GetInstance()->BindVertexArray(0);
+}
+
+void SpriteRenderer::InitBatchData() {
+    queuedTextures.reserve(INITIAL_BATCH_SIZE);
+    queued.reserve(INITIAL_BATCH_SIZE);
+    instances.reserve(INITIAL_BATCH_SIZE);
+
+    // The quad comes from the same buffer as for Draw(), every instance
+    // advances the attributes below by one sprite
+    glGenVertexArrays(1, &batchVAO);
+    glGenBuffers(1, &instanceVBO);
+    GLState::GetInstance()->BindVertexArray(batchVAO);
+    GLState::GetInstance()->BindArrayBuffer(quadVBO);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE,
                           4 * sizeof(float), (void*) 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+
+    instanceCapacity = INITIAL_BATCH_SIZE;
+    GLState::GetInstance()->BindArrayBuffer(instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER,
+                 instanceCapacity * sizeof(SpriteInstance), nullptr,
+                 GL_STREAM_DRAW);
+    // position and size
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance),
+                          (void*) offsetof(SpriteInstance, position));
+    glVertexAttribDivisor(1, 1);
+    // color and rotation
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance),
+                          (void*) offsetof(SpriteInstance, color));
+    glVertexAttribDivisor(2, 1);
+    // texture region
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance),
+                          (void*) offsetof(SpriteInstance, regionOffset));
+    glVertexAttribDivisor(3, 1);
+
+    GLState::GetInstance()->BindArrayBuffer(0);
+    GLState::GetInstance()->BindVertexArray(0);
 }
 
 void SpriteRenderer::Draw(const Texture2D* texture,
@@ -57,11 +113,79 @@ void SpriteRenderer::Draw(const Texture2D* texture,
 
     model = glm::scale(model, glm::vec3(size, 1.0f));
 
-    shader->setMat4("model", model);
-    shader->setVec3("spriteColor", color);
-    shader->setTexture("image", 0, texture);
+    shader->set(modelUniform, model);
+    shader->set(colorUniform, color);
+    shader->set(imageUniform, 0, texture);
 
-    glBindVertexArray(quadVAO);
+    GLState::GetInstance()->BindVertexArray(quadVAO);
     glDrawArrays(GL_TRIANGLES, 0, 6);
-    glBindVertexArray(0);
+}
+
+void SpriteRenderer::Submit(const TextureRegion& region,
+                            glm::vec2 position, glm::vec2 size,
+                            float rotate, glm::vec3 color) {
+    queuedTextures.push_back(region.texture);
+    queued.push_back({ position, size, color, glm::radians(rotate),
+                       region.offset, region.scale });
+}
+
+void SpriteRenderer::Flush() {
+    if (queued.empty()) {
+        return;
+    }
+    // A frame uses a handful of textures, so gathering each one's
+    // sprites with a scan per texture is cheaper than sorting
+    instances.clear();
+    std::size_t done = 0;
+    while (done < queued.size()) {
+        const Texture2D* texture = queuedTextures[done];
+        std::size_t first = instances.size();
+        for (std::size_t i = done; i < queued.size(); ++i) {
+            if (queuedTextures[i] == texture) {
+                instances.push_back(queued[i]);
+                // Taken, later scans skip it
+                queuedTextures[i] = nullptr;
+            }
+        }
+        // Move on to the next sprite not taken yet
+        while (done < queued.size() && !queuedTextures[done]) {
+            ++done;
+        }
+        batches.push_back({ texture, first, instances.size() - first });
+    }
+
+    if (instances.size() > instanceCapacity) {
+        instanceCapacity = std::max(instances.size(), instanceCapacity * 2);
+    }
+    GLState::GetInstance()->StreamArrayBuffer(
+        instanceVBO, instanceCapacity * sizeof(SpriteInstance),
+        instances.data(), instances.size() * sizeof(SpriteInstance));
+
+    batchShader->use();
+    GLState::GetInstance()->BindVertexArray(batchVAO);
+    for (const auto& batch : batches) {
+        drawInstances(batch.texture, batch.first, batch.count);
+    }
+
+    batches.clear();
+    queuedTextures.clear();
+    queued.clear();
+}
+
+void SpriteRenderer::drawInstances(const Texture2D* texture,
+                                   std::size_t first, std::size_t count) {
+    // GL 3.3 has no base instance, so the attributes are pointed at the
+    // first sprite of the batch instead
+    GLState::GetInstance()->BindArrayBuffer(instanceVBO);
+    std::size_t base = first * sizeof(SpriteInstance);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance),
+                          (void*) (base + offsetof(SpriteInstance, position)));
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance),
+                          (void*) (base + offsetof(SpriteInstance, color)));
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance),
+                          (void*) (base +
+                                   offsetof(SpriteInstance, regionOffset)));
+
+    batchShader->set(batchImageUniform, 0, texture);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, (GLsizei)count);
 }
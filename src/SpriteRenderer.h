@@ -2,17 +2,33 @@
 #define __SPRITERENDERER_H__
 
 #include <memory>
+#include <vector>
 
 #include <glad/glad.h>
 #include <glm/gtc/type_ptr.hpp>
 
-class Shader;
+#include "TextureAtlas.h"
+
+#include "Shader.h"
+
 class Texture2D;
 
+// Per-instance data of a batched sprite, as the batch shader reads it
+struct SpriteInstance {
+    glm::vec2 position;
+    glm::vec2 size;
+    glm::vec3 color;
+    float rotate; // radians
+    // Part of the texture, see TextureRegion
+    glm::vec2 regionOffset;
+    glm::vec2 regionScale;
+};
+
 class SpriteRenderer {
 public:
 
-    SpriteRenderer(const Shader* shader);
+    // shader draws single sprites, batchShader the batches
+    SpriteRenderer(const Shader* shader, const Shader* batchShader);
     ~SpriteRenderer();
 
     void Draw(
@@ -21,12 +37,46 @@ public:
         float rotate = 0.0f, glm::vec3 color = glm::vec3(1.0f)
         ) const;
 
+    // Queues a sprite for the next Flush(). Sprites from the same
+    // atlas share a batch.
+    void Submit(
+        const TextureRegion& region, glm::vec2 position,
+        glm::vec2 size = glm::vec2(10.0f, 10.0f),
+        float rotate = 0.0f, glm::vec3 color = glm::vec3(1.0f));
+    // Draws the queued sprites with one instanced draw per texture.
+    // Sprites of one flush may be drawn in any order, so flush between
+    // sprites that must overlap in a given order.
+    void Flush();
+
 private:
 
     const Shader* shader;
+    const Shader* batchShader;
+    Uniform<glm::mat4> modelUniform;
+    Uniform<glm::vec3> colorUniform;
+    Uniform<Sampler> imageUniform;
+    Uniform<Sampler> batchImageUniform;
     GLuint quadVAO;
     GLuint quadVBO;
 
+    // Batching
+    GLuint batchVAO = 0;
+    GLuint instanceVBO = 0;
+    std::size_t instanceCapacity = 0;
+    std::vector<const Texture2D*> queuedTextures;
+    std::vector<SpriteInstance> queued;
+    // The queued sprites reordered so each texture's are contiguous
+    std::vector<SpriteInstance> instances;
+    struct Batch {
+        const Texture2D* texture;
+        std::size_t first;
+        std::size_t count;
+    };
+    std::vector<Batch> batches;
+
     void InitRenderData();
+    void InitBatchData();
+    void drawInstances(const Texture2D* texture, std::size_t first,
+                       std::size_t count);
 };
 #endif
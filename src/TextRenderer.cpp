@@ -2,12 +2,15 @@
 
 #include <fmt/core.h>
 
+#include "GLState.h"
 #include "Shader.h"
 #include "Texture2D.h"
 #include "ResourceManager.h"
 
 TextRenderer::TextRenderer(const Shader* shader)
-    : shader(shader) {
+    : shader(shader)
+    , colorUniform(shader->GetUniform<glm::vec3>("textColor"))
+    , textUniform(shader->GetUniform<Sampler>("text")) {
     if (FT_Init_FreeType(&ft)) {
         fmt::print("ERROR::FREETYPE: Failed init FreeType library!\n");
     }
@@ -26,20 +29,20 @@ TextRenderer::TextRenderer(const Shader* shader)
 
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    GLState::GetInstance()->BindVertexArray(VAO);
+    GLState::GetInstance()->BindArrayBuffer(VBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4,
                  nullptr, GL_DYNAMIC_DRAW);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE,
                           4 * sizeof(float), 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    GLState::GetInstance()->BindArrayBuffer(0);
+    GLState::GetInstance()->BindVertexArray(0);
 }
 
 TextRenderer::~TextRenderer() {
-    glDeleteBuffers(1, &VBO);
-    glDeleteVertexArrays(1, &VAO);
+    GLState::GetInstance()->DeleteBuffer(VBO);
+    GLState::GetInstance()->DeleteVertexArray(VAO);
 }
 
 void TextRenderer::initCharacters() {
@@ -78,12 +81,14 @@ void TextRenderer::initCharacters() {
     glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 }
 
-void TextRenderer::RenderText(const std::string& text,
+void TextRenderer::RenderText(std::string_view text,
                               const glm::vec2& position,
                               float scale, const glm::vec3& color) {
     shader->use();
-    shader->setVec3("textColor", color);
-    glBindVertexArray(VAO);
+    shader->set(colorUniform, color);
+    GLState* state = GLState::GetInstance();
+    state->BindVertexArray(VAO);
+    state->BindArrayBuffer(VBO);
 
     float x = position.x;
     float y = position.y;
@@ -106,14 +111,11 @@ void TextRenderer::RenderText(const std::string& text,
             { xpos + w, ypos, 1.0f, 0.0f }
         };
 
-        shader->setTexture("text", 0, ch.texture.get());
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        shader->set(textUniform, 0, ch.texture.get());
         glBufferSubData(GL_ARRAY_BUFFER, 0,
                         sizeof(vertices), vertices);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
 
         glDrawArrays(GL_TRIANGLES, 0, 6);
         x += (ch.advance >> 6) * scale;
     }
-    glBindVertexArray(0);
 }
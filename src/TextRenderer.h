@@ -2,6 +2,7 @@
 #define __TEXTRENDERER_H__
 
 #include <memory>
+#include <string_view>
 #include <unordered_map>
 
 #include <glad/glad.h>
@@ -9,9 +10,9 @@
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
+#include "Shader.h"
 #include "Texture2D.h"
 
-class Shader;
 class Texture2D;
 
 struct Character {
@@ -26,7 +27,7 @@ public:
     TextRenderer(const Shader* shader);
     ~TextRenderer();
 
-    void RenderText(const std::string& text, const glm::vec2& position,
+    void RenderText(std::string_view text, const glm::vec2& position,
                     float scale = 1.0f,
                     const glm::vec3& color = glm::vec3(1.0f));
 private:
@@ -37,6 +38,8 @@ private:
     GLuint VAO;
     GLuint VBO;
     const Shader* shader;
+    Uniform<glm::vec3> colorUniform;
+    Uniform<Sampler> textUniform;
 
     std::unordered_map<char, Character> characters;
 
@@ -1,10 +1,11 @@
 #include "Texture2D.h"
 
+#include "GLState.h"
 #include "Utility.h"
 
 Texture2D::Texture2D(TextureSource* texture) {
     glGenTextures(1, &ID);
-    glBindTexture(GL_TEXTURE_2D, ID);
+    GLState::GetInstance()->BindTexture(0, ID);
     glTexImage2D(GL_TEXTURE_2D, 0, texture->internalFormat,
                  texture->width, texture->height, 0,
                  texture->format, texture->type, texture->data);
@@ -12,20 +13,20 @@ Texture2D::Texture2D(TextureSource* texture) {
         glGenerateMipmap(GL_TEXTURE_2D);
     }
     SetTexParams(texture->params);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLState::GetInstance()->BindTexture(0, 0);
     Utility::CheckGLError();
 }
 
 Texture2D::~Texture2D() {
-    glDeleteTextures(1, &ID);
+    GLState::GetInstance()->DeleteTexture(ID);
 }
 
 void Texture2D::SetTexParams(
     const std::vector<TexParameteri>& params) {
 
-    glBindTexture(GL_TEXTURE_2D, ID);
+    GLState::GetInstance()->BindTexture(0, ID);
     for (auto param : params) {
         glTexParameteri(GL_TEXTURE_2D, param.pname, param.param);
     }
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLState::GetInstance()->BindTexture(0, 0);
 }
@@ -0,0 +1,112 @@
+#include "TextureAtlas.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <fmt/core.h>
+
+#include "Texture2D.h"
+
+static int alignUp(int value, int alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+void TextureAtlas::Add(const std::string& name,
+                       const unsigned char* pixels,
+                       int width, int height) {
+    images.push_back({ name, width, height,
+            std::vector<unsigned char>(pixels,
+                                       pixels + width * height * 4) });
+}
+
+bool TextureAtlas::Build(int width) {
+    // Cells start and end on multiples of the padding, so every mip
+    // level down to the last one keeps the images apart
+    std::vector<int> order(images.size());
+    for (int i = 0; i < (int)order.size(); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+        return images[a].height > images[b].height;
+    });
+
+    struct Placement {
+        int x, y;
+    };
+    std::vector<Placement> placements(images.size());
+    int x = 0, y = 0, shelfHeight = 0;
+    for (int i : order) {
+        const auto& image = images[i];
+        int cellWidth = alignUp(image.width + 2 * PADDING, PADDING);
+        int cellHeight = alignUp(image.height + 2 * PADDING, PADDING);
+        if (cellWidth > width) {
+            fmt::print("Texture {} does not fit into an atlas {} wide!\n",
+                       image.name, width);
+            return false;
+        }
+        if (x + cellWidth > width) {
+            x = 0;
+            y += shelfHeight;
+            shelfHeight = 0;
+        }
+        placements[i] = { x + PADDING, y + PADDING };
+        x += cellWidth;
+        shelfHeight = std::max(shelfHeight, cellHeight);
+    }
+    int height = y + shelfHeight;
+
+    std::vector<unsigned char> pixels((std::size_t)width * height * 4, 0);
+    for (std::size_t i = 0; i < images.size(); ++i) {
+        const auto& image = images[i];
+        auto place = placements[i];
+        // Copy the image with its edge repeated into the padding
+        for (int row = -PADDING; row < image.height + PADDING; ++row) {
+            int srcRow = std::clamp(row, 0, image.height - 1);
+            for (int col = -PADDING; col < image.width + PADDING; ++col) {
+                int srcCol = std::clamp(col, 0, image.width - 1);
+                std::memcpy(
+                    &pixels[((std::size_t)(place.y + row) * width +
+                             place.x + col) * 4],
+                    &image.pixels[((std::size_t)srcRow * image.width +
+                                   srcCol) * 4],
+                    4);
+            }
+        }
+
+        TextureRegion region;
+        region.offset = glm::vec2((float)place.x / width,
+                                  (float)place.y / height);
+        region.scale = glm::vec2((float)image.width / width,
+                                 (float)image.height / height);
+        regions[image.name] = region;
+    }
+
+    int maxLevel = 0;
+    for (int border = PADDING; border > 1; border /= 2) {
+        ++maxLevel;
+    }
+    TextureSource ts;
+    ts.internalFormat = GL_RGBA;
+    ts.width = width;
+    ts.height = height;
+    ts.format = GL_RGBA;
+    ts.data = pixels.data();
+    ts.params = {
+        { GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE },
+        { GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE },
+        { GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR },
+        { GL_TEXTURE_MAG_FILTER, GL_LINEAR },
+        { GL_TEXTURE_MAX_LEVEL, maxLevel },
+    };
+    texture = std::make_unique<Texture2D>(&ts);
+    for (auto& [name, region] : regions) {
+        region.texture = texture.get();
+    }
+    images.clear();
+    return true;
+}
+
+const TextureRegion* TextureAtlas::GetRegion(const std::string& name) const {
+    auto it = regions.find(name);
+    return it == regions.end() ? nullptr : &it->second;
+}
@@ -0,0 +1,53 @@
+#ifndef __TEXTUREATLAS_H__
+#define __TEXTUREATLAS_H__
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/gtc/type_ptr.hpp>
+
+class Texture2D;
+
+// Part of a texture a sprite is drawn with. Texture coordinates of the
+// quad map to offset + uv * scale.
+struct TextureRegion {
+    const Texture2D* texture = nullptr;
+    glm::vec2 offset = glm::vec2(0.0f);
+    glm::vec2 scale = glm::vec2(1.0f);
+};
+
+// Packs images into one texture at load time, so sprites drawn with
+// any of them share a texture bind and a batch. Images are placed on
+// shelves, tallest first.
+class TextureAtlas {
+public:
+    // Every image is surrounded by copies of its edge this wide, so
+    // filtering never reaches a neighbour. Mip levels stop where the
+    // border would shrink below one texel.
+    static const int PADDING = 8;
+
+    // pixels are RGBA and copied
+    void Add(const std::string& name, const unsigned char* pixels,
+             int width, int height);
+    // Places the images added so far and uploads the texture. Returns
+    // false when they do not fit into width.
+    bool Build(int width);
+
+    const Texture2D* GetTexture() const { return texture.get(); }
+    // Null before Build or for unknown names
+    const TextureRegion* GetRegion(const std::string& name) const;
+
+private:
+    struct Image {
+        std::string name;
+        int width, height;
+        std::vector<unsigned char> pixels;
+    };
+    std::vector<Image> images;
+    std::unordered_map<std::string, TextureRegion> regions;
+    std::unique_ptr<Texture2D> texture;
+};
+
+#endif
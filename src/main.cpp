@@ -1,9 +1,20 @@
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <thread>
+#include <random>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include "FrameArena.h"
 #include "Game.h"
+#include "GLState.h"
+#include "sim/AllocTracker.h"
+#include "sim/FixedTimestep.h"
+#include "sim/SaveState.h"
 
 void framebuffer_size_callback(GLFWwindow *window,
                                int width, int height);
@@ -12,9 +23,74 @@ void key_callback(GLFWwindow* window, int key, int scancode,
 
 const int SCR_WIDTH = 800;
 const int SCR_HEIGHT = 600;
+// Frames of active play before --alloc-check starts failing, lets the
+// buffers that grow with the game settle first
+const int ALLOC_WARMUP_FRAMES = 120;
+// Catch-up steps a frame may run at 1x, scaled up with the time scale
+const int MAX_FRAME_STEPS = 8;
+// Fast-forward runs steps for this much real time between two rendered
+// frames, checking the clock after every batch of steps
+const double FAST_FORWARD_FRAME = 1.0 / 30.0;
+const int FAST_FORWARD_BATCH = 64;
+// Step length when fast-forwarding without a tick rate
+const float FAST_FORWARD_STEP = 1.0f / 120.0f;
 Game game(SCR_WIDTH, SCR_HEIGHT);
 
-int main() {
+int main(int argc, char** argv) {
+    // Simulation steps per second, 0 runs one step per rendered frame
+    // with the measured frame time
+    int tickRate = 120;
+    int workers = (int)std::thread::hardware_concurrency();
+    const char* recordPath = nullptr;
+    const char* replayPath = nullptr;
+    const char* loadPath = nullptr;
+    std::uint32_t seed = std::random_device()();
+    bool allocStats = false;
+    bool allocCheck = false;
+    bool glStats = false;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--tick-rate") && i + 1 < argc) {
+            tickRate = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--swept-collision")) {
+            game.GetSimulation().SetCollisionMode(CollisionMode::Swept);
+        } else if (!strcmp(argv[i], "--balls") && i + 1 < argc) {
+            game.GetSimulation().SetLaunchBalls(atoi(argv[++i]));
+        } else if (!strcmp(argv[i], "--workers") && i + 1 < argc) {
+            workers = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = (std::uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (!strcmp(argv[i], "--record") && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (!strcmp(argv[i], "--replay") && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (!strcmp(argv[i], "--time-scale") && i + 1 < argc) {
+            game.SetTimeScale((float)atof(argv[++i]));
+        } else if (!strcmp(argv[i], "--fast-forward")) {
+            game.SetFastForward(true);
+        } else if (!strcmp(argv[i], "--save") && i + 1 < argc) {
+            game.SetSavePath(argv[++i]);
+        } else if (!strcmp(argv[i], "--load") && i + 1 < argc) {
+            loadPath = argv[++i];
+        } else if (!strcmp(argv[i], "--alloc-stats")) {
+            allocStats = true;
+        } else if (!strcmp(argv[i], "--particles") && i + 1 < argc) {
+            game.SetParticleCount(std::max(1, atoi(argv[++i])));
+        } else if (!strcmp(argv[i], "--gl-stats")) {
+            glStats = true;
+        } else if (!strcmp(argv[i], "--alloc-check")) {
+            allocCheck = true;
+        }
+    }
+    // A replay starts from a fresh game, one loaded from a save would
+    // not play back the same
+    if (loadPath && (recordPath || replayPath)) {
+        std::cout << "--load cannot be combined with --record or "
+                     "--replay!\n";
+        return -1;
+    }
+    game.GetSimulation().SetWorkerCount(workers);
+    game.GetSimulation().SetSeed(seed);
+
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
@@ -40,32 +116,141 @@ int main() {
 
     glDisable(GL_DEPTH_TEST);
     glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::GetInstance()->BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     glViewport(0, 0, SCR_WIDTH, SCR_HEIGHT);
 
     game.Init();
+    if (loadPath && !LoadSaveState(loadPath, game.GetSimulation())) {
+        return -1;
+    }
+    if (replayPath && !game.StartReplay(replayPath)) {
+        return -1;
+    }
+    if (recordPath && !game.StartRecording(recordPath)) {
+        return -1;
+    }
 
-    float deltaTime = 0.0f;
-    float lastFrame = 0.0f;
+    FixedTimestep timestep(tickRate > 0 ? tickRate : 1, MAX_FRAME_STEPS);
+    double deltaTime = 0.0;
+    double lastFrame = glfwGetTime();
+    int steadyFrames = 0;
+    int statFrames = 0;
+    AllocStats statTotal;
+    std::uint64_t statPeak = 0;
+    double statStart = lastFrame;
+    int glStatFrames = 0;
+    double glStatStart = lastFrame;
+    long long fastForwardSteps = 0;
+    double fastForwardStart = lastFrame;
 
     while (!glfwWindowShouldClose(window)) {
-        float currentFrame = (float)glfwGetTime();
+        double currentFrame = glfwGetTime();
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
         glfwPollEvents();
 
-        game.ProcessInput(deltaTime);
+        game.ProcessInput((float)deltaTime);
+
+        // Only gameplay frames count as steady, menus and level changes
+        // are allowed to allocate
+        AllocTracker::BeginFrame();
+        if (game.GetSimulation().State == GameState::GAME_ACTIVE) {
+            ++steadyFrames;
+        } else {
+            steadyFrames = 0;
+        }
+        AllocTracker::SetStrict(allocCheck &&
+                                steadyFrames > ALLOC_WARMUP_FRAMES);
 
-        game.Update(deltaTime);
+        float alpha = 1.0f;
+        if (game.IsFastForward()) {
+            // Only the last of all the steps run in a frame's worth of
+            // real time is rendered
+            float step = tickRate > 0 ? timestep.StepSize() :
+                FAST_FORWARD_STEP;
+            double until = currentFrame + FAST_FORWARD_FRAME;
+            do {
+                for (int i = 0; i < FAST_FORWARD_BATCH; ++i) {
+                    game.Update(step);
+                }
+                fastForwardSteps += FAST_FORWARD_BATCH;
+            } while (glfwGetTime() < until);
+            double elapsed = glfwGetTime() - fastForwardStart;
+            if (elapsed >= 1.0) {
+                std::cout << "Fast-forward: "
+                          << (long long)(fastForwardSteps / elapsed)
+                          << " steps/s, "
+                          << fastForwardSteps * step / elapsed
+                          << "x real time\n";
+                fastForwardSteps = 0;
+                fastForwardStart = glfwGetTime();
+            }
+        } else if (tickRate > 0) {
+            float scale = game.GetTimeScale();
+            timestep.SetMaxSteps(MAX_FRAME_STEPS * (int)std::ceil(scale));
+            int steps = timestep.Advance(deltaTime * scale);
+            for (int i = 0; i < steps; ++i) {
+                game.Update(timestep.StepSize());
+            }
+            alpha = timestep.Alpha();
+        } else {
+            // Without a tick rate the steps themselves get longer
+            game.Update((float)deltaTime * game.GetTimeScale());
+        }
+        game.HandleEvents();
+        if (!game.IsFastForward()) {
+            fastForwardSteps = 0;
+            fastForwardStart = currentFrame;
+        }
 
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
-        game.Render();
+        game.Render(alpha);
+        AllocTracker::SetStrict(false);
+
+        if (allocStats) {
+            AllocStats frame = AllocTracker::FrameStats();
+            statTotal.allocations += frame.allocations;
+            statTotal.bytes += frame.bytes;
+            statPeak = std::max(statPeak, frame.allocations);
+            ++statFrames;
+            if (currentFrame - statStart >= 1.0) {
+                std::cout << "Allocations per frame: "
+                          << statTotal.allocations / statFrames
+                          << " average, " << statPeak << " peak, "
+                          << statTotal.bytes / statFrames
+                          << " bytes average\n";
+                statFrames = 0;
+                statTotal = AllocStats();
+                statPeak = 0;
+                statStart = currentFrame;
+            }
+        }
+
+        if (glStats) {
+            ++glStatFrames;
+            if (currentFrame - glStatStart >= 1.0) {
+                const auto& stats = GLState::GetInstance()->Stats();
+                std::cout << "GL state changes per frame: "
+                          << stats.issued / glStatFrames << " issued, "
+                          << stats.filtered / glStatFrames
+                          << " filtered\n";
+                GLState::GetInstance()->ResetStats();
+                glStatFrames = 0;
+                glStatStart = currentFrame;
+            }
+        }
 
         glfwSwapBuffers(window);
+        // everything allocated from the frame arena dies with the frame
+        FrameArena::GetInstance()->Reset();
     }
 
+    game.StopRecording();
     glfwTerminate();
+    if (allocStats) {
+        AllocTracker::PrintSites();
+    }
 
 	return 0;
 }
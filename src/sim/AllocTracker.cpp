@@ -0,0 +1,203 @@
+#include "AllocTracker.h"
+
+#include <cstdlib>
+#include <new>
+
+#include <fmt/core.h>
+
+static std::atomic<std::uint64_t> totalAllocations{0};
+static std::atomic<std::uint64_t> totalBytes{0};
+static std::atomic<std::uint64_t> totalFrees{0};
+static std::atomic<bool> strictMode{false};
+static std::atomic<AllocSite*> sites{nullptr};
+
+static AllocStats frameStart;
+
+static thread_local AllocSite* currentSite = nullptr;
+static thread_local int permits = 0;
+// Set while reporting a strict mode violation, the report itself may
+// allocate
+static thread_local bool reporting = false;
+
+static void record(std::size_t size) {
+    totalAllocations.fetch_add(1, std::memory_order_relaxed);
+    totalBytes.fetch_add(size, std::memory_order_relaxed);
+    if (currentSite) {
+        currentSite->allocations.fetch_add(1, std::memory_order_relaxed);
+        currentSite->bytes.fetch_add(size, std::memory_order_relaxed);
+    }
+    if (strictMode.load(std::memory_order_relaxed) && permits == 0 &&
+        !reporting) {
+        reporting = true;
+        fmt::print(stderr,
+                   "Allocation of {} bytes in {} during a steady-state "
+                   "frame\n",
+                   size, currentSite ? currentSite->name : "unknown site");
+        std::abort();
+    }
+}
+
+static void* allocate(std::size_t size) {
+    record(size);
+    return std::malloc(size ? size : 1);
+}
+
+static void* allocateAligned(std::size_t size, std::align_val_t align) {
+    record(size);
+    auto alignment = static_cast<std::size_t>(align);
+    size = (size + alignment - 1) / alignment * alignment;
+#ifdef _WIN32
+    return _aligned_malloc(size ? size : alignment, alignment);
+#else
+    return std::aligned_alloc(alignment, size ? size : alignment);
+#endif
+}
+
+static void release(void* p) {
+    if (p) {
+        totalFrees.fetch_add(1, std::memory_order_relaxed);
+        std::free(p);
+    }
+}
+
+static void releaseAligned(void* p) {
+    if (p) {
+        totalFrees.fetch_add(1, std::memory_order_relaxed);
+#ifdef _WIN32
+        _aligned_free(p);
+#else
+        std::free(p);
+#endif
+    }
+}
+
+AllocSite::AllocSite(const char* name)
+    : name(name) {
+    next = sites.load();
+    while (!sites.compare_exchange_weak(next, this)) {
+    }
+}
+
+AllocStats AllocTracker::Totals() {
+    AllocStats stats;
+    stats.allocations = totalAllocations.load(std::memory_order_relaxed);
+    stats.bytes = totalBytes.load(std::memory_order_relaxed);
+    stats.frees = totalFrees.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void AllocTracker::BeginFrame() {
+    frameStart = Totals();
+}
+
+AllocStats AllocTracker::FrameStats() {
+    AllocStats stats = Totals();
+    stats.allocations -= frameStart.allocations;
+    stats.bytes -= frameStart.bytes;
+    stats.frees -= frameStart.frees;
+    return stats;
+}
+
+void AllocTracker::SetStrict(bool strict) {
+    strictMode.store(strict);
+}
+
+bool AllocTracker::IsStrict() {
+    return strictMode.load();
+}
+
+void AllocTracker::PrintSites() {
+    for (AllocSite* site = sites.load(); site; site = site->next) {
+        fmt::print("{:32} {:10} allocations {:12} bytes\n", site->name,
+                   site->allocations.load(), site->bytes.load());
+    }
+}
+
+AllocTracker::Permit::Permit() {
+    ++permits;
+}
+
+AllocTracker::Permit::~Permit() {
+    --permits;
+}
+
+AllocTracker::Scope::Scope(AllocSite& site)
+    : previous(currentSite) {
+    currentSite = &site;
+}
+
+AllocTracker::Scope::~Scope() {
+    currentSite = previous;
+}
+
+void* operator new(std::size_t size) {
+    void* p = allocate(size);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+    void* p = allocateAligned(size, align);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](std::size_t size, std::align_val_t align) {
+    return operator new(size, align);
+}
+
+void operator delete(void* p) noexcept {
+    release(p);
+}
+
+void operator delete[](void* p) noexcept {
+    release(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    release(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    release(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    release(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    release(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    releaseAligned(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+    releaseAligned(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+    releaseAligned(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept {
+    releaseAligned(p);
+}
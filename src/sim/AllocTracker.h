@@ -0,0 +1,80 @@
+#ifndef __ALLOCTRACKER_H__
+#define __ALLOCTRACKER_H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Counters for heap allocations made through operator new
+struct AllocStats {
+    std::uint64_t allocations = 0;
+    std::uint64_t bytes = 0;
+    std::uint64_t frees = 0;
+};
+
+// A named region of code that allocations are attributed to, declared
+// through ALLOC_SCOPE
+struct AllocSite {
+    explicit AllocSite(const char* name);
+
+    const char* name;
+    std::atomic<std::uint64_t> allocations{0};
+    std::atomic<std::uint64_t> bytes{0};
+    AllocSite* next = nullptr;
+};
+
+// Replaces the global operator new and delete to count every heap
+// allocation of the program. Counting is always on, attributing the
+// allocations to call sites only in builds that define
+// BREAKOUT_ALLOC_SITES (debug builds do).
+class AllocTracker {
+public:
+    // Everything since the program started
+    static AllocStats Totals();
+    // FrameStats() counts from the last BeginFrame()
+    static void BeginFrame();
+    static AllocStats FrameStats();
+
+    // While strict, an allocation on any thread that is not covered by
+    // a Permit reports where it happened and aborts
+    static void SetStrict(bool strict);
+    static bool IsStrict();
+
+    // Prints the counters of every site that was entered so far
+    static void PrintSites();
+
+    // Allows the current thread to allocate in strict mode while it
+    // lives, for work that is expected to allocate
+    class Permit {
+    public:
+        Permit();
+        ~Permit();
+        Permit(const Permit&) = delete;
+        Permit& operator=(const Permit&) = delete;
+    };
+
+    // Attributes the allocations of the current thread to a site while
+    // it lives, scopes nest
+    class Scope {
+    public:
+        explicit Scope(AllocSite& site);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        AllocSite* previous;
+    };
+};
+
+#ifdef BREAKOUT_ALLOC_SITES
+#define ALLOC_CONCAT_(a, b) a##b
+#define ALLOC_CONCAT(a, b) ALLOC_CONCAT_(a, b)
+#define ALLOC_SCOPE(name)                                               \
+    static AllocSite ALLOC_CONCAT(allocSite, __LINE__)(name);           \
+    AllocTracker::Scope ALLOC_CONCAT(allocScope, __LINE__)(             \
+        ALLOC_CONCAT(allocSite, __LINE__))
+#else
+#define ALLOC_SCOPE(name) ((void)0)
+#endif
+
+#endif
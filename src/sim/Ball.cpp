@@ -0,0 +1,16 @@
+#include "Ball.h"
+
+Ball::Ball(EntityStore& store, const BallAttribute& ballAttr)
+    : GameObject(store, ballAttr)
+    , radius(ballAttr.radius)
+    , isStatic(ballAttr.isStatic)
+    , isSticky(ballAttr.isSticky)
+    , isPassThrough(ballAttr.isPassThrough) { }
+
+Ball::~Ball() { }
+
+void Ball::Update(float dt) {
+    if (!isStatic) {
+        GameObject::Update(dt);
+    }
+}
@@ -19,11 +19,14 @@ struct BallAttribute : public GameObjectAttribute {
 class Ball : public GameObject {
 public:
 
-    Ball(const BallAttribute& ballAttr);
+    Ball(EntityStore& store, const BallAttribute& ballAttr);
     ~Ball();
 
     void Update(float dt) override;
-    BallAttribute* Attr() override;
-    const BallAttribute* Attr() const override;
+
+    float radius;
+    bool isStatic;
+    bool isSticky;
+    bool isPassThrough;
 };
 #endif
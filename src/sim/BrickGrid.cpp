@@ -0,0 +1,89 @@
+#include "BrickGrid.h"
+
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+
+void BrickGrid::Build(int tileColumns, int tileRows, glm::vec2 tileSize,
+                      int tilesPerCell,
+                      const std::vector<glm::ivec2>& brickTiles) {
+    assert(tilesPerCell > 0);
+    columns = std::max(1, (tileColumns + tilesPerCell - 1) / tilesPerCell);
+    rows = std::max(1, (tileRows + tilesPerCell - 1) / tilesPerCell);
+    cellSize = tileSize * (float)tilesPerCell;
+
+    int cellNum = columns * rows;
+    std::size_t brickNum = brickTiles.size();
+    brickCell.resize(brickNum);
+    brickSlot.resize(brickNum);
+
+    // Counting sort of the bricks by cell
+    cellStart.assign(cellNum + 1, 0);
+    for (std::size_t i = 0; i < brickNum; ++i) {
+        int x = std::min(brickTiles[i].x / tilesPerCell, columns - 1);
+        int y = std::min(brickTiles[i].y / tilesPerCell, rows - 1);
+        brickCell[i] = y * columns + x;
+        ++cellStart[brickCell[i] + 1];
+    }
+    for (int c = 0; c < cellNum; ++c) {
+        cellStart[c + 1] += cellStart[c];
+    }
+
+    items.resize(brickNum);
+    std::vector<std::uint32_t> fill(cellStart.begin(), cellStart.end() - 1);
+    for (std::size_t i = 0; i < brickNum; ++i) {
+        brickSlot[i] = fill[brickCell[i]]++;
+        items[brickSlot[i]] = (Index)i;
+    }
+
+    Restore();
+}
+
+void BrickGrid::Remove(Index brick) {
+    std::uint32_t cell = brickCell[brick];
+    std::uint32_t slot = brickSlot[brick];
+    std::uint32_t last = cellStart[cell] + cellCount[cell] - 1;
+    if (slot > last) {
+        return; // already removed
+    }
+
+    Index moved = items[last];
+    items[last] = brick;
+    items[slot] = moved;
+    brickSlot[moved] = slot;
+    brickSlot[brick] = last;
+    --cellCount[cell];
+}
+
+void BrickGrid::Restore() {
+    cellCount.resize(cellStart.size() - 1);
+    for (std::size_t c = 0; c < cellCount.size(); ++c) {
+        cellCount[c] = cellStart[c + 1] - cellStart[c];
+    }
+}
+
+void BrickGrid::Query(glm::vec2 min, glm::vec2 max,
+                      std::vector<Index>& result) const {
+    if (items.empty()) {
+        return;
+    }
+    int x0 = (int)std::floor(min.x / cellSize.x);
+    int y0 = (int)std::floor(min.y / cellSize.y);
+    int x1 = (int)std::floor(max.x / cellSize.x);
+    int y1 = (int)std::floor(max.y / cellSize.y);
+    if (x1 < 0 || y1 < 0 || x0 >= columns || y0 >= rows) {
+        return;
+    }
+    x0 = std::max(x0, 0);
+    y0 = std::max(y0, 0);
+    x1 = std::min(x1, columns - 1);
+    y1 = std::min(y1, rows - 1);
+
+    for (int y = y0; y <= y1; ++y) {
+        for (int x = x0; x <= x1; ++x) {
+            int cell = y * columns + x;
+            auto begin = items.begin() + cellStart[cell];
+            result.insert(result.end(), begin, begin + cellCount[cell]);
+        }
+    }
+}
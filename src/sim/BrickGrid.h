@@ -0,0 +1,45 @@
+#ifndef __BRICKGRID_H__
+#define __BRICKGRID_H__
+
+#include <vector>
+#include <cstdint>
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include "EntityStore.h"
+
+// Uniform grid over the tile layout of a level. Every brick is filed
+// under the cell containing its tile, a query returns the bricks of
+// all cells overlapping a box. Destroyed bricks are taken out so they
+// cost nothing until Restore() puts them back.
+class BrickGrid {
+public:
+    using Index = EntityStore::Index;
+
+    // brickTiles[i] is the tile (column, row) of brick i
+    void Build(int tileColumns, int tileRows, glm::vec2 tileSize,
+               int tilesPerCell, const std::vector<glm::ivec2>& brickTiles);
+    void Remove(Index brick);
+    void Restore();
+
+    // Appends the live bricks of every cell overlapping [min, max]
+    void Query(glm::vec2 min, glm::vec2 max,
+               std::vector<Index>& result) const;
+
+private:
+
+    int columns = 0;
+    int rows = 0;
+    glm::vec2 cellSize = glm::vec2(1.0f);
+
+    // bricks of cell c are items[cellStart[c], cellStart[c + 1]), the
+    // first cellCount[c] of them are alive
+    std::vector<std::uint32_t> cellStart;
+    std::vector<std::uint32_t> cellCount;
+    std::vector<Index> items;
+    // cell of a brick and its position in items
+    std::vector<std::uint32_t> brickCell;
+    std::vector<std::uint32_t> brickSlot;
+};
+
+#endif
@@ -0,0 +1,203 @@
+#include "CollisionKernel.h"
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+#define KERNEL_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang only emit AVX2 code in functions marked for it, MSVC
+// accepts the intrinsics anywhere
+#if defined(KERNEL_X86) && (defined(__GNUC__) || defined(__clang__))
+#define KERNEL_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define KERNEL_TARGET_AVX2
+#endif
+
+KernelIsa BestKernelIsa() {
+#if defined(KERNEL_X86)
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] >= 7) {
+        __cpuidex(info, 7, 0);
+        if (info[1] & (1 << 5)) {
+            return KernelIsa::AVX2;
+        }
+    }
+    return KernelIsa::SSE2;
+#else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return KernelIsa::AVX2;
+    }
+    return KernelIsa::SSE2;
+#endif
+#else
+    return KernelIsa::Scalar;
+#endif
+}
+
+const char* KernelIsaName(KernelIsa isa) {
+    switch (isa) {
+    case KernelIsa::SSE2:
+        return "sse2";
+    case KernelIsa::AVX2:
+        return "avx2";
+    default:
+        return "scalar";
+    }
+}
+
+void BoxBatch::Reserve(int count) {
+    minX.reserve(count);
+    minY.reserve(count);
+    maxX.reserve(count);
+    maxY.reserve(count);
+}
+
+void CircleHits::Reserve(int count) {
+    mask.reserve((count + 31) / 32);
+    dx.reserve(count);
+    dy.reserve(count);
+}
+
+void BoxBatch::Clear() {
+    minX.clear();
+    minY.clear();
+    maxX.clear();
+    maxY.clear();
+}
+
+void BoxBatch::Add(float x0, float y0, float x1, float y1) {
+    minX.push_back(x0);
+    minY.push_back(y0);
+    maxX.push_back(x1);
+    maxY.push_back(y1);
+}
+
+static void setHit(std::uint32_t* mask, int i) {
+    mask[i >> 5] |= 1u << (i & 31);
+}
+
+// Handles boxes [begin, end) one at a time, also used for the tail the
+// vector loops leave
+static int scalarRange(float cx, float cy, float radius,
+                       const BoxBatch& boxes, CircleHits& hits,
+                       int begin, int end) {
+    float r2 = radius * radius;
+    int count = 0;
+    for (int i = begin; i < end; ++i) {
+        float px = std::min(std::max(cx, boxes.minX[i]), boxes.maxX[i]);
+        float py = std::min(std::max(cy, boxes.minY[i]), boxes.maxY[i]);
+        float dx = px - cx;
+        float dy = py - cy;
+        if (dx * dx + dy * dy < r2) {
+            hits.dx[i] = dx;
+            hits.dy[i] = dy;
+            setHit(hits.mask.data(), i);
+            ++count;
+        }
+    }
+    return count;
+}
+
+#if defined(KERNEL_X86)
+static int popcount8(int bits) {
+    int count = 0;
+    for (; bits; bits &= bits - 1) {
+        ++count;
+    }
+    return count;
+}
+
+static int sse2Range(float cx, float cy, float radius,
+                     const BoxBatch& boxes, CircleHits& hits, int end) {
+    __m128 x = _mm_set1_ps(cx);
+    __m128 y = _mm_set1_ps(cy);
+    __m128 r2 = _mm_set1_ps(radius * radius);
+    int count = 0;
+    int i = 0;
+    for (; i + 4 <= end; i += 4) {
+        __m128 px = _mm_min_ps(_mm_max_ps(x, _mm_loadu_ps(&boxes.minX[i])),
+                               _mm_loadu_ps(&boxes.maxX[i]));
+        __m128 py = _mm_min_ps(_mm_max_ps(y, _mm_loadu_ps(&boxes.minY[i])),
+                               _mm_loadu_ps(&boxes.maxY[i]));
+        __m128 dx = _mm_sub_ps(px, x);
+        __m128 dy = _mm_sub_ps(py, y);
+        __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        int bits = _mm_movemask_ps(_mm_cmplt_ps(d2, r2));
+        if (bits) {
+            _mm_storeu_ps(&hits.dx[i], dx);
+            _mm_storeu_ps(&hits.dy[i], dy);
+            hits.mask[i >> 5] |= (std::uint32_t)bits << (i & 31);
+            count += popcount8(bits);
+        }
+    }
+    return count + scalarRange(cx, cy, radius, boxes, hits, i, end);
+}
+
+KERNEL_TARGET_AVX2
+static int avx2Range(float cx, float cy, float radius,
+                     const BoxBatch& boxes, CircleHits& hits, int end) {
+    __m256 x = _mm256_set1_ps(cx);
+    __m256 y = _mm256_set1_ps(cy);
+    __m256 r2 = _mm256_set1_ps(radius * radius);
+    int count = 0;
+    int i = 0;
+    for (; i + 8 <= end; i += 8) {
+        __m256 px = _mm256_min_ps(
+            _mm256_max_ps(x, _mm256_loadu_ps(&boxes.minX[i])),
+            _mm256_loadu_ps(&boxes.maxX[i]));
+        __m256 py = _mm256_min_ps(
+            _mm256_max_ps(y, _mm256_loadu_ps(&boxes.minY[i])),
+            _mm256_loadu_ps(&boxes.maxY[i]));
+        __m256 dx = _mm256_sub_ps(px, x);
+        __m256 dy = _mm256_sub_ps(py, y);
+        // No FMA here, the result has to match the other paths bit for bit
+        __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx),
+                                  _mm256_mul_ps(dy, dy));
+        int bits = _mm256_movemask_ps(_mm256_cmp_ps(d2, r2, _CMP_LT_OQ));
+        if (bits) {
+            _mm256_storeu_ps(&hits.dx[i], dx);
+            _mm256_storeu_ps(&hits.dy[i], dy);
+            hits.mask[i >> 5] |= (std::uint32_t)bits << (i & 31);
+            count += popcount8(bits);
+        }
+    }
+    return count + scalarRange(cx, cy, radius, boxes, hits, i, end);
+}
+#endif
+
+int CircleVsBoxes(KernelIsa isa, float cx, float cy, float radius,
+                  const BoxBatch& boxes, CircleHits& hits) {
+    int count = boxes.Size();
+    hits.mask.assign((count + 31) / 32, 0);
+    hits.dx.resize(count);
+    hits.dy.resize(count);
+
+    switch (isa) {
+#if defined(KERNEL_X86)
+    case KernelIsa::AVX2:
+        return avx2Range(cx, cy, radius, boxes, hits, count);
+    case KernelIsa::SSE2:
+        return sse2Range(cx, cy, radius, boxes, hits, count);
+#endif
+    default:
+        return scalarRange(cx, cy, radius, boxes, hits, 0, count);
+    }
+}
+
+int CirclesVsBoxes(KernelIsa isa, const float* cx, const float* cy,
+                   const float* radius, int circles,
+                   const BoxBatch& boxes, CircleHits* hits) {
+    int count = 0;
+    for (int c = 0; c < circles; ++c) {
+        count += CircleVsBoxes(isa, cx[c], cy[c], radius[c], boxes, hits[c]);
+    }
+    return count;
+}
@@ -0,0 +1,52 @@
+#ifndef __COLLISIONKERNEL_H__
+#define __COLLISIONKERNEL_H__
+
+#include <vector>
+#include <cstdint>
+
+// Instruction set a batch collision test runs on
+enum class KernelIsa {
+    Scalar,
+    SSE2,
+    AVX2,
+};
+
+// The widest instruction set the running CPU supports
+KernelIsa BestKernelIsa();
+const char* KernelIsaName(KernelIsa isa);
+
+// Boxes as four parallel arrays of edges, the input of the batch tests
+struct BoxBatch {
+    std::vector<float> minX, minY, maxX, maxY;
+
+    int Size() const { return (int)minX.size(); }
+    void Reserve(int count);
+    void Clear();
+    void Add(float x0, float y0, float x1, float y1);
+};
+
+// Result of testing one circle against a BoxBatch
+struct CircleHits {
+    // bit i of word i / 32 is set when box i overlaps the circle
+    std::vector<std::uint32_t> mask;
+    // vector from the circle center to the closest point of box i, only
+    // valid where the mask bit is set
+    std::vector<float> dx, dy;
+
+    bool Hit(int i) const { return mask[i >> 5] & (1u << (i & 31)); }
+    // Room for a batch of count boxes
+    void Reserve(int count);
+};
+
+// Tests a circle against every box of the batch, returns the number of
+// overlapping boxes. A box overlaps when the distance from the center
+// to its closest point is below the radius.
+int CircleVsBoxes(KernelIsa isa, float cx, float cy, float radius,
+                  const BoxBatch& boxes, CircleHits& hits);
+
+// The same for several circles, hits[c] receives the result of circle c
+int CirclesVsBoxes(KernelIsa isa, const float* cx, const float* cy,
+                   const float* radius, int circles,
+                   const BoxBatch& boxes, CircleHits* hits);
+
+#endif
@@ -0,0 +1,69 @@
+#include "EntityStore.h"
+
+#include <cassert>
+
+#include "GameObject.h"
+
+EntityStore::Index EntityStore::Add(const GameObjectAttribute& attr) {
+    std::uint8_t flag = 0;
+    if (attr.isSolid) {
+        flag |= ENTITY_SOLID;
+    }
+    if (attr.isDestroyed) {
+        flag |= ENTITY_DESTROYED;
+    }
+
+    if (!freeRows.empty()) {
+        Index index = freeRows.back();
+        freeRows.pop_back();
+        positions[index] = attr.position;
+        previousPositions[index] = attr.position;
+        sizes[index] = attr.size;
+        velocities[index] = attr.velocity;
+        colors[index] = attr.color;
+        rotations[index] = attr.rotation;
+        flags[index] = flag;
+        sprites[index] = attr.sprite;
+        return index;
+    }
+
+    positions.push_back(attr.position);
+    previousPositions.push_back(attr.position);
+    sizes.push_back(attr.size);
+    velocities.push_back(attr.velocity);
+    colors.push_back(attr.color);
+    rotations.push_back(attr.rotation);
+    flags.push_back(flag);
+    sprites.push_back(attr.sprite);
+    return Size() - 1;
+}
+
+void EntityStore::Remove(Index index) {
+    assert(index < Size());
+    assert(!HasFlag(index, ENTITY_FREE));
+    flags[index] = ENTITY_FREE;
+    freeRows.push_back(index);
+}
+
+void EntityStore::Clear() {
+    positions.clear();
+    previousPositions.clear();
+    sizes.clear();
+    velocities.clear();
+    colors.clear();
+    rotations.clear();
+    flags.clear();
+    sprites.clear();
+    freeRows.clear();
+}
+
+void EntityStore::Reserve(std::size_t count) {
+    positions.reserve(count);
+    previousPositions.reserve(count);
+    sizes.reserve(count);
+    velocities.reserve(count);
+    colors.reserve(count);
+    rotations.reserve(count);
+    flags.reserve(count);
+    sprites.reserve(count);
+}
@@ -0,0 +1,63 @@
+#ifndef __ENTITYSTORE_H__
+#define __ENTITYSTORE_H__
+
+#include <vector>
+#include <cstdint>
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include "Sprite.h"
+
+struct GameObjectAttribute;
+
+enum EntityFlags : std::uint8_t {
+    ENTITY_SOLID = 1 << 0,
+    ENTITY_DESTROYED = 1 << 1,
+    // the slot is unused and waits in the free list
+    ENTITY_FREE = 1 << 2,
+};
+
+// Entity data stored as parallel arrays, one row per entity, so passes
+// touching only some of the fields (collision, movement, drawing) walk
+// contiguous memory. Removed rows are recycled, indices of live rows
+// never change.
+class EntityStore {
+public:
+    using Index = std::uint32_t;
+
+    Index Add(const GameObjectAttribute& attr);
+    void Remove(Index index);
+    void Clear();
+    void Reserve(std::size_t count);
+
+    // Number of rows including free ones
+    Index Size() const { return (Index)flags.size(); }
+
+    bool HasFlag(Index index, std::uint8_t flag) const {
+        return flags[index] & flag;
+    }
+    void SetFlag(Index index, std::uint8_t flag, bool value) {
+        flags[index] = value ? flags[index] | flag : flags[index] & ~flag;
+    }
+    // Neither free nor destroyed
+    bool IsAlive(Index index) const {
+        return !(flags[index] & (ENTITY_FREE | ENTITY_DESTROYED));
+    }
+
+    std::vector<glm::vec2> positions;
+    // position at the start of the last simulation step, used by the
+    // renderer to interpolate between steps
+    std::vector<glm::vec2> previousPositions;
+    std::vector<glm::vec2> sizes;
+    std::vector<glm::vec2> velocities;
+    std::vector<glm::vec3> colors;
+    std::vector<float> rotations;
+    std::vector<std::uint8_t> flags;
+    std::vector<Sprite> sprites;
+
+private:
+
+    std::vector<Index> freeRows;
+};
+
+#endif
@@ -0,0 +1,33 @@
+#include "FixedTimestep.h"
+
+#include <cassert>
+
+FixedTimestep::FixedTimestep(int hz, int maxSteps)
+    : hz(hz)
+    , maxSteps(maxSteps)
+    , step(1.0 / hz) {
+    assert(hz > 0);
+    assert(maxSteps > 0);
+}
+
+void FixedTimestep::SetMaxSteps(int maxSteps) {
+    assert(maxSteps > 0);
+    this->maxSteps = maxSteps;
+}
+
+int FixedTimestep::Advance(double frameTime) {
+    if (frameTime > 0.0) {
+        accumulator += frameTime;
+    }
+
+    int steps = 0;
+    while (accumulator >= step && steps < maxSteps) {
+        accumulator -= step;
+        ++steps;
+    }
+
+    if (steps == maxSteps && accumulator >= step) {
+        accumulator = 0.0;
+    }
+    return steps;
+}
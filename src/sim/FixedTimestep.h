@@ -0,0 +1,32 @@
+#ifndef __FIXEDTIMESTEP_H__
+#define __FIXEDTIMESTEP_H__
+
+// Splits variable frame times into simulation steps of constant
+// length. Leftover time is carried over to the next frame, Alpha()
+// tells how far the renderer is between the last two steps.
+class FixedTimestep {
+public:
+    // maxSteps bounds the catch-up work of a single frame, time beyond
+    // that is dropped so a long hitch slows the game down instead of
+    // stalling it
+    FixedTimestep(int hz, int maxSteps = 8);
+
+    // Adds elapsed real time and returns how many steps to run
+    int Advance(double frameTime);
+    // Scaled up with the time scale, a frame of 64x game time needs
+    // that many more steps
+    void SetMaxSteps(int maxSteps);
+
+    float StepSize() const { return (float)step; }
+    int Rate() const { return hz; }
+    float Alpha() const { return (float)(accumulator / step); }
+
+private:
+
+    int hz;
+    int maxSteps;
+    double step;
+    double accumulator = 0.0;
+};
+
+#endif
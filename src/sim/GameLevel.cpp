@@ -0,0 +1,203 @@
+#include "GameLevel.h"
+
+#include <fstream>
+#include <string>
+#include <sstream>
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+
+#include <fmt/core.h>
+
+#include "GameObject.h"
+
+// Grid cells are at least this large so a ball query touches only a
+// few of them even on levels with tiny bricks
+const float MIN_GRID_CELL_SIZE = 32.0f;
+
+GameLevel::GameLevel() { }
+
+GameLevel::~GameLevel() { }
+
+std::shared_ptr<const LevelData> LevelData::Load(const std::string& path) {
+    std::ifstream fstream(path);
+    if (!fstream) {
+        fmt::print("Failed loading level file {}!\n", path);
+        return nullptr;
+    }
+
+    auto data = std::make_shared<LevelData>();
+    data->path = path;
+    while (fstream) {
+        std::string line;
+        std::getline(fstream, line);
+        if (!fstream) {
+            break;
+        }
+
+        std::stringstream ss(line);
+        int tileCode;
+        std::vector<int> row;
+        while (ss >> tileCode) {
+            row.push_back(tileCode);
+        }
+
+        data->tiles.push_back(row);
+    }
+    return data;
+}
+
+bool GameLevel::Load(const std::string& path,
+                     int levelWidth, int levelHeight) {
+    return Load(LevelData::Load(path), levelWidth, levelHeight);
+}
+
+bool GameLevel::Load(std::shared_ptr<const LevelData> data,
+                     int levelWidth, int levelHeight) {
+    if (!data) {
+        return false;
+    }
+    this->data = std::move(data);
+    init(this->data->tiles, levelWidth, levelHeight);
+    return true;
+}
+
+int GameLevel::RemainingBricks(int tileCode) const {
+    return tileCode >= 0 && tileCode < (int)codeRemaining.size() ?
+        codeRemaining[tileCode] : 0;
+}
+
+int GameLevel::DestructibleBricks(int tileCode) const {
+    return tileCode >= 0 && tileCode < (int)codeTotals.size() ?
+        codeTotals[tileCode] : 0;
+}
+
+float GameLevel::Progress() const {
+    return destructible ?
+        (float)(destructible - remaining) / (float)destructible : 1.0f;
+}
+
+void GameLevel::init(const std::vector<std::vector<int>>& tileData,
+                     int levelWidth, int levelHeight) {
+
+    int row = tileData.size();
+    if (!row) {
+        return;
+    }
+    int col = tileData[0].size();
+    if (!col) {
+        return;
+    }
+
+    float brickWidth = (float)levelWidth / (float)col;
+    float brickHeight = (float)levelHeight / (float)row;
+    bricks.Clear();
+    bricks.Reserve(row * col);
+    brickCodes.clear();
+    destructible = 0;
+    codeTotals.clear();
+    std::vector<glm::ivec2> brickTiles;
+    brickTiles.reserve(row * col);
+    for (int i = 0; i < row; ++i) {
+        for (int j = 0; j < col; ++j) {
+            if (!tileData[i][j]) {
+                continue;
+            }
+            GameObjectAttribute attr;
+            attr.size = glm::vec2(brickWidth, brickHeight);
+            attr.position = glm::vec2(j * brickWidth, i * brickHeight);
+            attr.velocity = glm::vec2(0.0f);
+            attr.rotation = 0;
+            attr.isDestroyed = false;
+            if (tileData[i][j] == 1) {
+                attr.color = glm::vec3(0.8f, 0.8f, 0.7f);
+                attr.sprite = Sprite::BrickSolid;
+                attr.isSolid = true;
+            } else if (tileData[i][j] > 1) {
+                switch (tileData[i][j]) {
+                case 2:
+                    attr.color = glm::vec3(0.2f, 0.6f, 1.0f);
+                    break;
+                case 3:
+                    attr.color = glm::vec3(0.0f, 0.7f, 0.0f);
+                    break;
+                case 4:
+                    attr.color = glm::vec3(0.8f, 0.8f, 0.4f);
+                    break;
+                case 5:
+                    attr.color = glm::vec3(1.0f, 0.5f, 0.5f);
+                    break;
+                default:
+                    assert(false);
+                    break;
+                }
+                attr.isSolid = false;
+                attr.sprite = Sprite::Brick;
+            }
+            bricks.Add(attr);
+            brickTiles.emplace_back(j, i);
+            int code = tileData[i][j];
+            brickCodes.push_back((std::uint8_t)code);
+            if (!attr.isSolid) {
+                if (code >= (int)codeTotals.size()) {
+                    codeTotals.resize(code + 1, 0);
+                }
+                ++codeTotals[code];
+                ++destructible;
+            }
+        }
+    }
+
+    float tileSize = std::min(brickWidth, brickHeight);
+    int tilesPerCell = std::max(
+        1, (int)std::ceil(MIN_GRID_CELL_SIZE / tileSize));
+    grid.Build(col, row, glm::vec2(brickWidth, brickHeight),
+               tilesPerCell, brickTiles);
+    remaining = destructible;
+    codeRemaining = codeTotals;
+}
+
+void GameLevel::Reset() {
+    for (auto& flag : bricks.flags) {
+        flag &= ~ENTITY_DESTROYED;
+    }
+    grid.Restore();
+    remaining = destructible;
+    codeRemaining = codeTotals;
+}
+
+void GameLevel::SaveDestroyed(std::uint64_t* bits) const {
+    std::fill(bits, bits + BrickWords(), 0);
+    for (EntityStore::Index i = 0; i < bricks.Size(); ++i) {
+        if (bricks.HasFlag(i, ENTITY_DESTROYED)) {
+            bits[i / 64] |= 1ull << (i % 64);
+        }
+    }
+}
+
+void GameLevel::RestoreDestroyed(const std::uint64_t* bits) {
+    // The grid can only take bricks out one at a time, bringing any
+    // back needs a full reset
+    for (EntityStore::Index i = 0; i < bricks.Size(); ++i) {
+        bool destroyed = (bits[i / 64] >> (i % 64)) & 1;
+        if (!destroyed && bricks.HasFlag(i, ENTITY_DESTROYED)) {
+            Reset();
+            break;
+        }
+    }
+    for (EntityStore::Index i = 0; i < bricks.Size(); ++i) {
+        if ((bits[i / 64] >> (i % 64)) & 1) {
+            DestroyBrick(i);
+        }
+    }
+}
+
+void GameLevel::DestroyBrick(EntityStore::Index brick) {
+    if (!bricks.IsAlive(brick) || bricks.HasFlag(brick, ENTITY_SOLID)) {
+        return;
+    }
+    bricks.SetFlag(brick, ENTITY_DESTROYED, true);
+    grid.Remove(brick);
+    --remaining;
+    --codeRemaining[brickCodes[brick]];
+}
@@ -0,0 +1,71 @@
+#ifndef __GAMELEVEL_H__
+#define __GAMELEVEL_H__
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <cstdint>
+
+#include "EntityStore.h"
+#include "BrickGrid.h"
+
+// Tile codes of a level file. Parsed once and shared read-only by every
+// GameLevel built from it, each of which keeps its own bricks.
+struct LevelData {
+    std::string path;
+    std::vector<std::vector<int>> tiles;
+
+    // path is a file system path, not relative to the project root.
+    // Returns nullptr if the file cannot be read.
+    static std::shared_ptr<const LevelData> Load(const std::string& path);
+};
+
+class GameLevel {
+public:
+    GameLevel();
+    ~GameLevel();
+    // path is a file system path, not relative to the project root
+    bool Load(const std::string& path, int levelWidth, int levelHeight);
+    bool Load(std::shared_ptr<const LevelData> data,
+              int levelWidth, int levelHeight);
+    const LevelData* GetData() const { return data.get(); }
+    // All destructible bricks are gone
+    bool IsComplete() const { return remaining == 0; }
+    void Reset();
+    // Marks a brick destroyed and takes it out of the grid. Solid and
+    // already destroyed bricks are left alone.
+    void DestroyBrick(EntityStore::Index brick);
+
+    // Destructible bricks left and in total, kept up to date by
+    // DestroyBrick and Reset so none of these scan the bricks
+    int RemainingBricks() const { return remaining; }
+    int DestructibleBricks() const { return destructible; }
+    // Same for the bricks of one tile code of the level file
+    int RemainingBricks(int tileCode) const;
+    int DestructibleBricks(int tileCode) const;
+    // Share of the destructible bricks destroyed, from 0 to 1
+    float Progress() const;
+
+    // Destroyed bricks as a bitmap of BrickWords() words, bit i is set
+    // when brick i is destroyed
+    int BrickWords() const { return ((int)bricks.Size() + 63) / 64; }
+    void SaveDestroyed(std::uint64_t* bits) const;
+    void RestoreDestroyed(const std::uint64_t* bits);
+
+    EntityStore bricks;
+    BrickGrid grid;
+    // Tile code each brick was made from
+    std::vector<std::uint8_t> brickCodes;
+
+private:
+    std::shared_ptr<const LevelData> data;
+    int destructible = 0;
+    int remaining = 0;
+    // Indexed by tile code
+    std::vector<int> codeTotals;
+    std::vector<int> codeRemaining;
+
+    void init(const std::vector<std::vector<int>>& tileData,
+              int levelWidth, int levelHeight);
+};
+#endif
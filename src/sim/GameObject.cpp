@@ -0,0 +1,64 @@
+#include "GameObject.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+GameObject::
+GameObject(EntityStore& store, const GameObjectAttribute& objAttr)
+    : store(store)
+    , index(store.Add(objAttr)) { }
+
+GameObject::~GameObject() {
+    if (parent) {
+        parent->Detach(this);
+    }
+    while (firstChild) {
+        Detach(firstChild);
+    }
+    store.Remove(index);
+}
+
+void GameObject::Update(float dt) {
+    glm::vec2 displace = dt * Velocity();
+    Position() += displace;
+
+    for (GameObject* child = firstChild; child; child = child->nextSibling) {
+        child->Position() += displace;
+        child->Update(dt);
+    }
+}
+
+void GameObject::Attach(GameObject* child) {
+    if (child->parent == this) {
+        return;
+    }
+    if (child->parent) {
+        child->parent->Detach(child);
+    }
+    child->parent = this;
+    child->prevSibling = lastChild;
+    if (lastChild) {
+        lastChild->nextSibling = child;
+    } else {
+        firstChild = child;
+    }
+    lastChild = child;
+}
+
+void GameObject::Detach(GameObject* child) {
+    if (child->parent != this) {
+        return;
+    }
+    if (child->prevSibling) {
+        child->prevSibling->nextSibling = child->nextSibling;
+    } else {
+        firstChild = child->nextSibling;
+    }
+    if (child->nextSibling) {
+        child->nextSibling->prevSibling = child->prevSibling;
+    } else {
+        lastChild = child->prevSibling;
+    }
+    child->parent = nullptr;
+    child->prevSibling = nullptr;
+    child->nextSibling = nullptr;
+}
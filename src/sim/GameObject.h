@@ -0,0 +1,83 @@
+#ifndef __GAMEOBJECT_H__
+#define __GAMEOBJECT_H__
+
+#include <memory>
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include "EntityStore.h"
+#include "Sprite.h"
+
+// Initial values of an entity
+struct GameObjectAttribute {
+    glm::vec2 size;
+    glm::vec2 position;
+    glm::vec2 velocity;
+    glm::vec3 color;
+    float rotation = 0.0f;
+    bool isSolid = true;
+    bool isDestroyed = false;
+    Sprite sprite = Sprite::None;
+};
+
+// An entity with behaviour. Its data lives in a row of an EntityStore
+// which the object owns for its lifetime, the object itself only adds
+// what the row does not hold. Plain entities without behaviour, like
+// bricks, are only rows.
+class GameObject {
+public:
+
+    GameObject(EntityStore& store, const GameObjectAttribute& objAttr);
+    virtual ~GameObject();
+
+    GameObject(const GameObject&) = delete;
+    GameObject& operator=(const GameObject&) = delete;
+
+    virtual void Update(float dt);
+
+    const EntityStore& Store() const { return store; }
+    EntityStore::Index Index() const { return index; }
+
+    glm::vec2& Position() { return store.positions[index]; }
+    const glm::vec2& Position() const { return store.positions[index]; }
+    glm::vec2& Size() { return store.sizes[index]; }
+    const glm::vec2& Size() const { return store.sizes[index]; }
+    glm::vec2& Velocity() { return store.velocities[index]; }
+    const glm::vec2& Velocity() const { return store.velocities[index]; }
+    glm::vec3& Color() { return store.colors[index]; }
+    const glm::vec3& Color() const { return store.colors[index]; }
+
+    bool IsDestroyed() const {
+        return store.HasFlag(index, ENTITY_DESTROYED);
+    }
+    void SetDestroyed(bool destroyed) {
+        store.SetFlag(index, ENTITY_DESTROYED, destroyed);
+    }
+
+    // Children move along with their parent and are updated after it,
+    // in the order they were attached. An object has at most one
+    // parent, attaching it elsewhere detaches it first.
+    void Attach(GameObject* child);
+    // Does nothing if child is not attached to this object
+    void Detach(GameObject* child);
+
+    GameObject* Parent() const { return parent; }
+    GameObject* FirstChild() const { return firstChild; }
+    GameObject* NextSibling() const { return nextSibling; }
+
+protected:
+
+    EntityStore& store;
+    EntityStore::Index index;
+
+private:
+
+    // Intrusive list of children, attaching and detaching never
+    // allocates
+    GameObject* parent = nullptr;
+    GameObject* firstChild = nullptr;
+    GameObject* lastChild = nullptr;
+    GameObject* prevSibling = nullptr;
+    GameObject* nextSibling = nullptr;
+};
+#endif
@@ -0,0 +1,17 @@
+#ifndef __INPUT_H__
+#define __INPUT_H__
+
+// Player input consumed by one call of Simulation::ProcessInput. The
+// movement flags mirror whether a key is held, the others are edges
+// and should only be set on the frame the key went down.
+struct InputState {
+    bool left = false;
+    bool right = false;
+    bool launch = false;
+    bool prevLevel = false;
+    bool nextLevel = false;
+    bool confirm = false;
+    bool skipLevel = false;
+};
+
+#endif
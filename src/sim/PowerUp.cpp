@@ -0,0 +1,63 @@
+#include "PowerUp.h"
+
+#include <memory>
+
+static const PowerUpInfo POWER_UP_INFO[] = {
+    { "speed", 75, 0.0f, glm::vec3(0.5f, 0.5f, 1.0f),
+      Sprite::PowerUpSpeed },
+    { "sticky", 75, 20.0f, glm::vec3(1.0f, 0.5f, 1.0f),
+      Sprite::PowerUpSticky },
+    { "pass-through", 75, 10.0f, glm::vec3(0.5f, 1.0f, 0.5f),
+      Sprite::PowerUpPassThrough },
+    { "pad-size-increase", 75, 0.0f, glm::vec3(1.0f, 0.6f, 0.4f),
+      Sprite::PowerUpPadSizeIncrease },
+    { "confuse", 15, 3.0f, glm::vec3(1.0f, 0.3f, 0.3f),
+      Sprite::PowerUpConfuse },
+    { "chaos", 15, 3.0f, glm::vec3(0.9f, 0.25f, 0.25f),
+      Sprite::PowerUpChaos },
+    { "split", 75, 0.0f, glm::vec3(1.0f, 1.0f, 0.4f),
+      Sprite::PowerUpSplit },
+};
+static_assert(sizeof(POWER_UP_INFO) / sizeof(POWER_UP_INFO[0]) ==
+              (std::size_t)PowerUpType::Count,
+              "every power-up type needs an entry");
+
+const glm::vec2 POWER_UP_SIZE = glm::vec2(60.0f, 20.0f);
+const glm::vec2 POWER_UP_VELOCITY = glm::vec2(0.0f, 150.0f);
+
+const PowerUpInfo& GetPowerUpInfo(PowerUpType type) {
+    return POWER_UP_INFO[(int)type];
+}
+
+PowerUp::PowerUp(EntityStore& store, const PowerUpAttribute& puAttr)
+    : GameObject(store, puAttr)
+    , type(puAttr.type)
+    , duration(puAttr.duration)
+    , isActive(puAttr.isActive) { }
+
+PowerUp::~PowerUp() { }
+
+void PowerUp::Update(float dt) {
+    GameObject::Update(dt);
+    if (isActive) {
+        duration -= dt;
+        if (duration <= 0.0f) {
+            isActive = false;
+        }
+    }
+}
+
+void PowerUp::Reset(PowerUpType type, glm::vec2 position) {
+    const auto& info = GetPowerUpInfo(type);
+    this->type = type;
+    duration = info.duration;
+    isActive = false;
+    Position() = position;
+    store.previousPositions[index] = position;
+    Size() = POWER_UP_SIZE;
+    Velocity() = POWER_UP_VELOCITY;
+    Color() = info.color;
+    store.rotations[index] = 0.0f;
+    store.sprites[index] = info.sprite;
+    store.flags[index] = ENTITY_SOLID;
+}
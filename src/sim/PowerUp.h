@@ -0,0 +1,65 @@
+#ifndef __POWERUP_H__
+#define __POWERUP_H__
+
+#include <cstdint>
+
+#include "GameObject.h"
+
+enum class PowerUpType : std::uint8_t {
+    Speed,
+    Sticky,
+    PassThrough,
+    PadSizeIncrease,
+    Confuse,
+    Chaos,
+    Split,
+    Count,
+};
+
+// What all power-ups of a type share
+struct PowerUpInfo {
+    const char* name;
+    // Rolled for every destroyed brick, one in spawnChance drops it
+    int spawnChance;
+    // Seconds the effect lasts once collected, 0 for instant ones
+    float duration;
+    glm::vec3 color;
+    Sprite sprite;
+};
+
+// Drops are rolled in the order of PowerUpType
+const PowerUpInfo& GetPowerUpInfo(PowerUpType type);
+
+struct PowerUpAttribute : public GameObjectAttribute {
+    PowerUpType type = PowerUpType::Speed;
+    float duration = 0.0f;
+    bool isActive = false;
+
+    PowerUpAttribute() { }
+    PowerUpAttribute(const GameObjectAttribute& objAttr)
+        : GameObjectAttribute(objAttr) { }
+};
+
+class PowerUp : public GameObject {
+public:
+    PowerUp(EntityStore& store, const PowerUpAttribute& puAttr);
+    ~PowerUp();
+    // Falls, and counts down while active. isActive turns false when
+    // the effect runs out, the owner reacts to that.
+    void Update(float dt) override;
+    // Turns the object into a fresh, uncollected drop of a type
+    void Reset(PowerUpType type, glm::vec2 position);
+
+    PowerUpType type;
+    float duration;
+    bool isActive;
+};
+
+// class SpeedPowerUp : public PowerUp {
+// public:
+//     SpeedPowerUp();
+
+// private:
+//     static const PowerUpAttribute ATTR;
+// };
+#endif
@@ -0,0 +1,74 @@
+#include "PowerUpPool.h"
+
+#include <cassert>
+#include <algorithm>
+
+#include "EntityStore.h"
+
+PowerUpPool::PowerUpPool(EntityStore& store, int capacity) {
+    assert(capacity > 0 && capacity < 0xffff);
+    PowerUpAttribute attr;
+    attr.isDestroyed = true;
+    slots.reserve(capacity);
+    for (int i = 0; i < capacity; ++i) {
+        slots.push_back(std::make_unique<PowerUp>(store, attr));
+    }
+    generations.assign(capacity, 0);
+    // Popped from the back, so slot 0 is used first
+    for (int i = capacity - 1; i >= 0; --i) {
+        freeSlots.push_back((std::uint16_t)i);
+    }
+    active.reserve(capacity);
+    activeSlots.reserve(capacity);
+}
+
+PowerUpHandle PowerUpPool::Spawn(PowerUpType type, glm::vec2 position) {
+    PowerUpHandle handle;
+    if (freeSlots.empty()) {
+        return handle;
+    }
+    handle.slot = freeSlots.back();
+    freeSlots.pop_back();
+    handle.generation = ++generations[handle.slot];
+
+    PowerUp* p = slots[handle.slot].get();
+    p->Reset(type, position);
+    active.push_back(p);
+    activeSlots.push_back(handle.slot);
+    return handle;
+}
+
+void PowerUpPool::Release(PowerUpHandle handle) {
+    if (!isLive(handle)) {
+        return;
+    }
+    auto it = std::find(activeSlots.begin(), activeSlots.end(), handle.slot);
+    auto i = it - activeSlots.begin();
+    active.erase(active.begin() + i);
+    activeSlots.erase(it);
+    free(handle.slot);
+}
+
+void PowerUpPool::Clear() {
+    ReleaseIf([](const PowerUp&) { return true; });
+}
+
+PowerUp* PowerUpPool::Get(PowerUpHandle handle) {
+    return isLive(handle) ? slots[handle.slot].get() : nullptr;
+}
+
+const PowerUp* PowerUpPool::Get(PowerUpHandle handle) const {
+    return isLive(handle) ? slots[handle.slot].get() : nullptr;
+}
+
+bool PowerUpPool::isLive(PowerUpHandle handle) const {
+    return handle.slot < slots.size() &&
+        generations[handle.slot] == handle.generation;
+}
+
+void PowerUpPool::free(std::uint16_t slot) {
+    ++generations[slot];
+    slots[slot]->SetDestroyed(true);
+    slots[slot]->isActive = false;
+    freeSlots.push_back(slot);
+}
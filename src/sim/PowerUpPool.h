@@ -0,0 +1,78 @@
+#ifndef __POWERUPPOOL_H__
+#define __POWERUPPOOL_H__
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include "PowerUp.h"
+
+class EntityStore;
+
+// Refers to a power-up in a PowerUpPool. It stays valid until the
+// power-up is released, after that Get returns null even when the
+// slot has been reused.
+struct PowerUpHandle {
+    std::uint16_t slot = 0xffff;
+    std::uint16_t generation = 0;
+
+    bool IsValid() const { return slot != 0xffff; }
+};
+
+// A fixed number of power-ups made up front. Spawning and releasing
+// reuse them through a free list, so play never allocates for
+// power-ups no matter how many bricks break at once.
+class PowerUpPool {
+public:
+    PowerUpPool(EntityStore& store, int capacity);
+
+    // Returns an invalid handle when every power-up is in use
+    PowerUpHandle Spawn(PowerUpType type, glm::vec2 position);
+    void Release(PowerUpHandle handle);
+    void Clear();
+
+    PowerUp* Get(PowerUpHandle handle);
+    const PowerUp* Get(PowerUpHandle handle) const;
+
+    // Power-ups in use, in the order they were spawned
+    const std::vector<PowerUp*>& Active() const { return active; }
+    int Capacity() const { return (int)slots.size(); }
+
+    // Releases every power-up for which pred returns true, keeping the
+    // order of the others
+    template <typename Pred>
+    void ReleaseIf(Pred pred);
+
+private:
+
+    std::vector<std::unique_ptr<PowerUp>> slots;
+    // Bumped on every spawn and release, odd while the slot is in use
+    std::vector<std::uint16_t> generations;
+    std::vector<std::uint16_t> freeSlots;
+    // Power-ups in use and their slots, in parallel
+    std::vector<PowerUp*> active;
+    std::vector<std::uint16_t> activeSlots;
+
+    bool isLive(PowerUpHandle handle) const;
+    void free(std::uint16_t slot);
+};
+
+template <typename Pred>
+void PowerUpPool::ReleaseIf(Pred pred) {
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < active.size(); ++i) {
+        if (pred(*active[i])) {
+            free(activeSlots[i]);
+        } else {
+            active[kept] = active[i];
+            activeSlots[kept] = activeSlots[i];
+            ++kept;
+        }
+    }
+    active.resize(kept);
+    activeSlots.resize(kept);
+}
+
+#endif
@@ -0,0 +1,20 @@
+#include "Random.h"
+
+void Random::Seed(std::uint64_t seed, RandomStream stream) {
+    state = 0;
+    increment = ((std::uint64_t)stream << 1u) | 1u;
+    Next();
+    state += seed;
+    Next();
+}
+
+std::uint32_t Random::Below(std::uint32_t bound) {
+    // Reject the low values that would make some results more likely
+    std::uint32_t threshold = (0u - bound) % bound;
+    for (;;) {
+        std::uint32_t value = Next();
+        if (value >= threshold) {
+            return value % bound;
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef __RANDOM_H__
+#define __RANDOM_H__
+
+#include <cstdint>
+
+// Independent sequences for the same seed. Gameplay rolls decide the
+// outcome of a session, cosmetic ones only how it looks, so drawing
+// more or fewer particles never changes a power-up drop.
+enum class RandomStream : std::uint64_t {
+    Gameplay = 1,
+    Cosmetic = 2,
+};
+
+// PCG32 random number generator (pcg-random.org). 16 bytes of state
+// owned by whoever rolls, so sessions running in parallel never share
+// or contend on it.
+class Random {
+public:
+    explicit Random(std::uint64_t seed = 1,
+                    RandomStream stream = RandomStream::Gameplay) {
+        Seed(seed, stream);
+    }
+
+    void Seed(std::uint64_t seed, RandomStream stream);
+
+    std::uint32_t Next() {
+        std::uint64_t old = state;
+        state = old * 6364136223846793005ull + increment;
+        auto shifted = (std::uint32_t)(((old >> 18u) ^ old) >> 27u);
+        auto rotation = (std::uint32_t)(old >> 59u);
+        return (shifted >> rotation) | (shifted << ((-rotation) & 31));
+    }
+
+    // Uniform in [0, bound), bound must not be 0
+    std::uint32_t Below(std::uint32_t bound);
+
+    // Uniform in [0, 1)
+    float Float() {
+        return (Next() >> 8) * (1.0f / 16777216.0f);
+    }
+
+    // The raw generator, for writing it to a file and back
+    std::uint64_t GetState() const { return state; }
+    std::uint64_t GetIncrement() const { return increment; }
+    void SetState(std::uint64_t state, std::uint64_t increment) {
+        this->state = state;
+        this->increment = increment | 1u;
+    }
+
+private:
+
+    std::uint64_t state = 0;
+    std::uint64_t increment = 1;
+};
+
+#endif
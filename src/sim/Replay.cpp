@@ -0,0 +1,313 @@
+#include "Replay.h"
+
+#include <cmath>
+#include <cstring>
+#include <iterator>
+
+#include <fmt/core.h>
+
+#include "Ball.h"
+#include "GameLevel.h"
+#include "GameObject.h"
+#include "PowerUp.h"
+#include "Simulation.h"
+
+// File layout, all numbers little endian:
+//   magic, version, steps, final state, width, height, seed,
+//   collision mode, launch balls, level count, level hashes,
+//   then one record per step: a byte of input bits, bit 7 set when a
+//   float step length follows
+static const char MAGIC[8] = { 'B', 'O', 'R', 'E', 'P', 'L', 'A', 'Y' };
+// 2: power-up drops rolled with PCG32
+static const std::uint32_t VERSION = 2;
+// Where steps and final state are patched in on Close
+static const std::size_t STEPS_OFFSET = 12;
+static const std::uint8_t DT_FOLLOWS = 0x80;
+
+static void put(std::ofstream& file, std::uint64_t value, int bytes) {
+    char buffer[8];
+    for (int i = 0; i < bytes; ++i) {
+        buffer[i] = (char)(value >> (8 * i));
+    }
+    file.write(buffer, bytes);
+}
+
+static void putFloat(std::ofstream& file, float value) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    put(file, bits, 4);
+}
+
+static std::uint64_t get(const std::uint8_t* data, int bytes) {
+    std::uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value |= (std::uint64_t)data[i] << (8 * i);
+    }
+    return value;
+}
+
+static float getFloat(const std::uint8_t* data) {
+    auto bits = (std::uint32_t)get(data, 4);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static std::uint8_t packInput(const InputState& input) {
+    return (std::uint8_t)(input.left << 0 | input.right << 1 |
+                          input.launch << 2 | input.prevLevel << 3 |
+                          input.nextLevel << 4 | input.confirm << 5 |
+                          input.skipLevel << 6);
+}
+
+static InputState unpackInput(std::uint8_t bits) {
+    InputState input;
+    input.left = bits & (1 << 0);
+    input.right = bits & (1 << 1);
+    input.launch = bits & (1 << 2);
+    input.prevLevel = bits & (1 << 3);
+    input.nextLevel = bits & (1 << 4);
+    input.confirm = bits & (1 << 5);
+    input.skipLevel = bits & (1 << 6);
+    return input;
+}
+
+void HashBytes(std::uint64_t& hash, const void* data, std::size_t size) {
+    auto bytes = (const unsigned char*)data;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+}
+
+template <typename T>
+static void hashValue(std::uint64_t& hash, const T& value) {
+    HashBytes(hash, &value, sizeof(value));
+}
+
+std::uint64_t HashLevel(const LevelData& data) {
+    std::uint64_t hash = HASH_BASIS;
+    for (const auto& row : data.tiles) {
+        hashValue(hash, row.size());
+        for (int tile : row) {
+            hashValue(hash, tile);
+        }
+    }
+    return hash;
+}
+
+std::uint64_t HashState(const Simulation& sim) {
+    std::uint64_t hash = HASH_BASIS;
+    hashValue(hash, sim.State);
+    hashValue(hash, sim.GetLevelIndex());
+    hashValue(hash, sim.GetLives());
+    hashValue(hash, sim.GetEffects().confuse);
+    hashValue(hash, sim.GetEffects().chaos);
+
+    const GameObject* player = sim.GetPlayer();
+    hashValue(hash, player->Position());
+    hashValue(hash, player->Size());
+    for (const auto& ball : sim.GetBalls()) {
+        hashValue(hash, ball->Position());
+        hashValue(hash, ball->Velocity());
+        hashValue(hash, ball->isStatic);
+        hashValue(hash, ball->isSticky);
+        hashValue(hash, ball->isPassThrough);
+    }
+    for (const auto& p : sim.GetPowerUps()) {
+        hashValue(hash, p->type);
+        hashValue(hash, p->Position());
+        hashValue(hash, p->duration);
+        hashValue(hash, p->isActive);
+        hashValue(hash, p->IsDestroyed());
+    }
+    if (const GameLevel* level = sim.GetLevel()) {
+        const auto& flags = level->bricks.flags;
+        HashBytes(hash, flags.data(), flags.size());
+    }
+    return hash;
+}
+
+ReplayHeader MakeReplayHeader(const Simulation& sim) {
+    ReplayHeader header;
+    header.width = sim.Width;
+    header.height = sim.Height;
+    header.seed = sim.GetSeed();
+    header.collisionMode = (std::uint8_t)sim.GetCollisionMode();
+    header.launchBalls = sim.GetLaunchBalls();
+    for (int i = 0; i < sim.GetLevelCount(); ++i) {
+        header.levelHashes.push_back(HashLevel(*sim.GetLevelData(i)));
+    }
+    return header;
+}
+
+bool ApplyReplayHeader(const ReplayHeader& header, Simulation& sim) {
+    if (header.width != sim.Width || header.height != sim.Height) {
+        fmt::print("Replay was recorded at {}x{}, not {}x{}!\n",
+                   header.width, header.height, sim.Width, sim.Height);
+        return false;
+    }
+    if ((int)header.levelHashes.size() != sim.GetLevelCount()) {
+        fmt::print("Replay was recorded with {} levels, not {}!\n",
+                   header.levelHashes.size(), sim.GetLevelCount());
+        return false;
+    }
+    for (int i = 0; i < sim.GetLevelCount(); ++i) {
+        if (header.levelHashes[i] != HashLevel(*sim.GetLevelData(i))) {
+            fmt::print("Level {} differs from the recorded one!\n", i);
+            return false;
+        }
+    }
+    sim.SetSeed(header.seed);
+    sim.SetCollisionMode((CollisionMode)header.collisionMode);
+    sim.SetLaunchBalls(header.launchBalls);
+    return true;
+}
+
+ReplayWriter::~ReplayWriter() {
+    if (IsOpen()) {
+        file.close();
+    }
+}
+
+bool ReplayWriter::Open(const std::string& path,
+                        const ReplayHeader& header) {
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        fmt::print("Failed opening replay file {}!\n", path);
+        return false;
+    }
+    file.write(MAGIC, sizeof(MAGIC));
+    put(file, VERSION, 4);
+    put(file, 0, 8);
+    put(file, 0, 8);
+    put(file, (std::uint32_t)header.width, 4);
+    put(file, (std::uint32_t)header.height, 4);
+    put(file, header.seed, 4);
+    put(file, header.collisionMode, 1);
+    put(file, (std::uint32_t)header.launchBalls, 4);
+    put(file, header.levelHashes.size(), 4);
+    for (auto hash : header.levelHashes) {
+        put(file, hash, 8);
+    }
+    steps = 0;
+    lastDt = -1.0f;
+    return (bool)file;
+}
+
+void ReplayWriter::Record(const InputState& input, float dt) {
+    std::uint8_t bits = packInput(input);
+    if (dt != lastDt) {
+        put(file, bits | DT_FOLLOWS, 1);
+        putFloat(file, dt);
+        lastDt = dt;
+    } else {
+        put(file, bits, 1);
+    }
+    ++steps;
+}
+
+bool ReplayWriter::Close(std::uint64_t finalState) {
+    if (!IsOpen()) {
+        return false;
+    }
+    file.seekp(STEPS_OFFSET);
+    put(file, steps, 8);
+    put(file, finalState, 8);
+    file.close();
+    return !file.fail();
+}
+
+bool ReplayReader::Open(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        fmt::print("Failed opening replay file {}!\n", path);
+        return false;
+    }
+    data.assign(std::istreambuf_iterator<char>(file),
+                std::istreambuf_iterator<char>());
+
+    const std::size_t FIXED_SIZE = 8 + 4 + 8 + 8 + 4 + 4 + 4 + 1 + 4 + 4;
+    if (data.size() < FIXED_SIZE ||
+        std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) ||
+        get(&data[8], 4) != VERSION) {
+        fmt::print("{} is not a replay of this version!\n", path);
+        return false;
+    }
+    const std::uint8_t* p = &data[STEPS_OFFSET];
+    header.steps = get(p, 8);
+    header.finalState = get(p + 8, 8);
+    header.width = (std::int32_t)get(p + 16, 4);
+    header.height = (std::int32_t)get(p + 20, 4);
+    header.seed = (std::uint32_t)get(p + 24, 4);
+    header.collisionMode = (std::uint8_t)get(p + 28, 1);
+    header.launchBalls = (std::int32_t)get(p + 29, 4);
+    auto levelCount = (std::size_t)get(p + 33, 4);
+    if (header.collisionMode > (std::uint8_t)CollisionMode::Swept) {
+        fmt::print("Replay {} has unknown collision mode {}!\n", path,
+                   header.collisionMode);
+        return false;
+    }
+    if (header.launchBalls < 1 || header.launchBalls > MAX_LAUNCH_BALLS) {
+        fmt::print("Replay {} launches {} balls, not 1 to {}!\n", path,
+                   header.launchBalls, MAX_LAUNCH_BALLS);
+        return false;
+    }
+    start = FIXED_SIZE + 8 * levelCount;
+    if (data.size() < start) {
+        fmt::print("Replay file {} is truncated!\n", path);
+        return false;
+    }
+    header.levelHashes.clear();
+    for (std::size_t i = 0; i < levelCount; ++i) {
+        header.levelHashes.push_back(get(&data[FIXED_SIZE + 8 * i], 8));
+    }
+
+    // Every step length must be usable, and a recording that was cut
+    // off before Close has fewer steps than its header says
+    std::uint64_t steps = 0;
+    for (std::size_t i = start; i < data.size(); ++steps) {
+        if (data[i++] & DT_FOLLOWS) {
+            if (i + 4 > data.size()) {
+                fmt::print("Replay file {} is truncated!\n", path);
+                return false;
+            }
+            float dt = getFloat(&data[i]);
+            if (!std::isfinite(dt) || dt < 0.0f) {
+                fmt::print("Replay {} has step length {} at step {}!\n",
+                           path, dt, steps);
+                return false;
+            }
+            i += 4;
+        }
+    }
+    if (steps != header.steps) {
+        fmt::print("Replay {} holds {} steps but its header says {}, the "
+                   "recording was not finished!\n", path, steps,
+                   header.steps);
+        return false;
+    }
+    Rewind();
+    return true;
+}
+
+void ReplayReader::Rewind() {
+    offset = start;
+    lastDt = 0.0f;
+}
+
+bool ReplayReader::Next(InputState& input, float& dt) {
+    if (offset >= data.size()) {
+        return false;
+    }
+    std::uint8_t bits = data[offset++];
+    if (bits & DT_FOLLOWS) {
+        if (offset + 4 > data.size()) {
+            return false;
+        }
+        lastDt = getFloat(&data[offset]);
+        offset += 4;
+    }
+    input = unpackInput(bits);
+    dt = lastDt;
+    return true;
+}
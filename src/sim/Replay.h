@@ -0,0 +1,88 @@
+#ifndef __REPLAY_H__
+#define __REPLAY_H__
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+
+#include "Input.h"
+
+class Simulation;
+struct LevelData;
+
+// Everything besides the input that a recorded session depends on
+struct ReplayHeader {
+    std::int32_t width = 0;
+    std::int32_t height = 0;
+    std::uint32_t seed = 1;
+    std::uint8_t collisionMode = 0;
+    std::int32_t launchBalls = 1;
+    // One per level, in load order, so a replay can tell it is played
+    // on the levels it was recorded on
+    std::vector<std::uint64_t> levelHashes;
+    // Written when the recording is finished
+    std::uint64_t steps = 0;
+    std::uint64_t finalState = 0;
+};
+
+// Settings of sim as they are now, recording should start before its
+// first Update
+ReplayHeader MakeReplayHeader(const Simulation& sim);
+// Gives sim the recorded settings. Fails if the size or the loaded
+// levels differ from the recording.
+bool ApplyReplayHeader(const ReplayHeader& header, Simulation& sim);
+
+// FNV-1a, the hashes below and the save checksum are built on it.
+// HashBytes continues hash over size more bytes.
+const std::uint64_t HASH_BASIS = 14695981039346656037ull;
+void HashBytes(std::uint64_t& hash, const void* data, std::size_t size);
+
+std::uint64_t HashLevel(const LevelData& data);
+// Hash of the state that matters to gameplay, two simulations that
+// went through the same steps have the same hash
+std::uint64_t HashState(const Simulation& sim);
+
+// Writes the input and step length of every simulation step. A step
+// takes a single byte unless its length differs from the one before.
+class ReplayWriter {
+public:
+    ~ReplayWriter();
+
+    bool Open(const std::string& path, const ReplayHeader& header);
+    void Record(const InputState& input, float dt);
+    // Stores the step count and the final state for the replay to
+    // compare against
+    bool Close(std::uint64_t finalState);
+    bool IsOpen() const { return file.is_open(); }
+
+private:
+
+    std::ofstream file;
+    std::uint64_t steps = 0;
+    float lastDt = -1.0f;
+};
+
+// Reads a whole recording into memory and hands the steps out one by
+// one, fast enough to replay as a benchmark. Opening checks every step
+// length and rejects recordings that were not finished.
+class ReplayReader {
+public:
+    bool Open(const std::string& path);
+    const ReplayHeader& Header() const { return header; }
+
+    // Returns false after the last step
+    bool Next(InputState& input, float& dt);
+    // Starts over from the first step
+    void Rewind();
+
+private:
+
+    ReplayHeader header;
+    std::vector<std::uint8_t> data;
+    std::size_t start = 0;
+    std::size_t offset = 0;
+    float lastDt = 0.0f;
+};
+
+#endif
@@ -0,0 +1,464 @@
+#include "SaveState.h"
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+#include <fmt/core.h>
+
+#include "GameLevel.h"
+#include "Replay.h"
+#include "SimSnapshot.h"
+#include "Simulation.h"
+
+// File layout, all numbers little endian and every record at a fixed
+// offset that follows from the counts in the header:
+//
+//   header     HEADER_SIZE bytes
+//     0  magic               32  launch balls
+//     8  version             36  collision mode, 3 bytes padding
+//     12 header size         40  level count
+//     16 file size           44  ball count
+//     20 width               48  power-up count
+//     24 height              52  brick words
+//     28 seed                56  checksum of everything after the header
+//   level hashes   8 bytes each
+//   game state     STATE_SIZE bytes
+//   balls          BALL_SIZE bytes each
+//   power-ups      POWER_UP_RECORD_SIZE bytes each
+//   bricks         8 bytes per word of destroyed bits
+//
+// All record sizes are multiples of 8, so a mapped file can be read in
+// place.
+static const char MAGIC[8] = { 'B', 'O', 'S', 'A', 'V', 'E', 'S', 'T' };
+static const std::uint32_t VERSION = 1;
+static const std::size_t HEADER_SIZE = 64;
+static const std::size_t CHECKSUM_OFFSET = 56;
+// Counters of active power-ups, room for new types without a new version
+static const int POWER_UP_COUNTERS = 8;
+static const std::size_t STATE_SIZE = 112;
+static const std::size_t BALL_SIZE = 40;
+static const std::size_t POWER_UP_RECORD_SIZE = 24;
+
+static_assert((int)PowerUpType::Count <= POWER_UP_COUNTERS,
+              "power-up counters do not fit the save format");
+
+enum BallFlags : std::uint8_t {
+    SAVED_BALL_STATIC = 1 << 0,
+    SAVED_BALL_STICKY = 1 << 1,
+    SAVED_BALL_PASS_THROUGH = 1 << 2,
+    SAVED_BALL_ATTACHED = 1 << 3,
+};
+
+enum PowerUpFlags : std::uint8_t {
+    SAVED_POWER_UP_ACTIVE = 1 << 0,
+    SAVED_POWER_UP_DESTROYED = 1 << 1,
+};
+
+static void put(std::uint8_t* data, std::uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        data[i] = (std::uint8_t)(value >> (8 * i));
+    }
+}
+
+static void putFloat(std::uint8_t* data, float value) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    put(data, bits, 4);
+}
+
+static void putVec2(std::uint8_t* data, const glm::vec2& v) {
+    putFloat(data, v.x);
+    putFloat(data + 4, v.y);
+}
+
+static void putVec3(std::uint8_t* data, const glm::vec3& v) {
+    putFloat(data, v.x);
+    putFloat(data + 4, v.y);
+    putFloat(data + 8, v.z);
+}
+
+static std::uint64_t get(const std::uint8_t* data, int bytes) {
+    std::uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value |= (std::uint64_t)data[i] << (8 * i);
+    }
+    return value;
+}
+
+static float getFloat(const std::uint8_t* data) {
+    auto bits = (std::uint32_t)get(data, 4);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static glm::vec2 getVec2(const std::uint8_t* data) {
+    return glm::vec2(getFloat(data), getFloat(data + 4));
+}
+
+static glm::vec3 getVec3(const std::uint8_t* data) {
+    return glm::vec3(getFloat(data), getFloat(data + 4),
+                     getFloat(data + 8));
+}
+
+static bool finite(const glm::vec2& v) {
+    return std::isfinite(v.x) && std::isfinite(v.y);
+}
+
+static bool finite(const glm::vec3& v) {
+    return std::isfinite(v.x) && std::isfinite(v.y) && std::isfinite(v.z);
+}
+
+static std::uint64_t checksum(const std::uint8_t* data, std::size_t size) {
+    std::uint64_t hash = HASH_BASIS;
+    HashBytes(hash, data, size);
+    return hash;
+}
+
+static std::size_t fileSize(std::size_t levels, std::size_t balls,
+                            std::size_t powerUps, std::size_t brickWords) {
+    return HEADER_SIZE + 8 * levels + STATE_SIZE + BALL_SIZE * balls +
+        POWER_UP_RECORD_SIZE * powerUps + 8 * brickWords;
+}
+
+bool EncodeSaveState(const Simulation& sim, std::vector<std::uint8_t>& out) {
+    auto snapshot = std::make_unique<SimSnapshot>();
+    if (!sim.Capture(*snapshot)) {
+        fmt::print("The game state does not fit a save, it holds at most "
+                   "{} balls, {} power-ups and {} bricks!\n",
+                   MAX_SNAPSHOT_BALLS, MAX_SNAPSHOT_POWER_UPS,
+                   MAX_SNAPSHOT_BRICK_WORDS * 64);
+        return false;
+    }
+    const SimSnapshot& s = *snapshot;
+    int levelCount = sim.GetLevelCount();
+    out.assign(fileSize(levelCount, s.ballCount, s.powerUpCount,
+                        s.brickWords), 0);
+
+    std::uint8_t* p = out.data();
+    std::memcpy(p, MAGIC, sizeof(MAGIC));
+    put(p + 8, VERSION, 4);
+    put(p + 12, HEADER_SIZE, 4);
+    put(p + 16, out.size(), 4);
+    put(p + 20, (std::uint32_t)sim.Width, 4);
+    put(p + 24, (std::uint32_t)sim.Height, 4);
+    put(p + 28, sim.GetSeed(), 4);
+    put(p + 32, (std::uint32_t)sim.GetLaunchBalls(), 4);
+    put(p + 36, (std::uint8_t)sim.GetCollisionMode(), 1);
+    put(p + 40, levelCount, 4);
+    put(p + 44, s.ballCount, 4);
+    put(p + 48, s.powerUpCount, 4);
+    put(p + 52, s.brickWords, 4);
+    p += HEADER_SIZE;
+
+    for (int i = 0; i < levelCount; ++i) {
+        put(p, HashLevel(*sim.GetLevelData(i)), 8);
+        p += 8;
+    }
+
+    put(p, s.state, 1);
+    put(p + 1, s.confuse, 1);
+    put(p + 2, s.chaos, 1);
+    put(p + 4, (std::uint32_t)s.level, 4);
+    put(p + 8, (std::uint32_t)s.lives, 4);
+    put(p + 12, (std::uint32_t)s.pendingBalls, 4);
+    put(p + 16, s.random.GetState(), 8);
+    put(p + 24, s.random.GetIncrement(), 8);
+    for (int i = 0; i < (int)PowerUpType::Count; ++i) {
+        put(p + 32 + 4 * i, (std::uint32_t)s.activePowerUps[i], 4);
+    }
+    putVec2(p + 64, s.playerPosition);
+    putVec2(p + 72, s.playerPreviousPosition);
+    putVec2(p + 80, s.playerSize);
+    putVec2(p + 88, s.playerVelocity);
+    putVec3(p + 96, s.playerColor);
+    p += STATE_SIZE;
+
+    for (int i = 0; i < s.ballCount; ++i) {
+        const auto& ball = s.balls[i];
+        putVec2(p, ball.position);
+        putVec2(p + 8, ball.previousPosition);
+        putVec2(p + 16, ball.velocity);
+        putVec3(p + 24, ball.color);
+        put(p + 36,
+            (ball.isStatic ? SAVED_BALL_STATIC : 0) |
+            (ball.isSticky ? SAVED_BALL_STICKY : 0) |
+            (ball.isPassThrough ? SAVED_BALL_PASS_THROUGH : 0) |
+            (ball.isAttached ? SAVED_BALL_ATTACHED : 0), 1);
+        p += BALL_SIZE;
+    }
+
+    for (int i = 0; i < s.powerUpCount; ++i) {
+        const auto& powerUp = s.powerUps[i];
+        putVec2(p, powerUp.position);
+        putVec2(p + 8, powerUp.previousPosition);
+        putFloat(p + 16, powerUp.duration);
+        put(p + 20, (std::uint8_t)powerUp.type, 1);
+        put(p + 21,
+            (powerUp.isActive ? SAVED_POWER_UP_ACTIVE : 0) |
+            (powerUp.isDestroyed ? SAVED_POWER_UP_DESTROYED : 0), 1);
+        p += POWER_UP_RECORD_SIZE;
+    }
+
+    for (int i = 0; i < s.brickWords; ++i) {
+        put(p, s.destroyedBricks[i], 8);
+        p += 8;
+    }
+
+    put(out.data() + CHECKSUM_OFFSET,
+        checksum(out.data() + HEADER_SIZE, out.size() - HEADER_SIZE), 8);
+    return true;
+}
+
+bool DecodeSaveState(const std::uint8_t* data, std::size_t size,
+                     SaveHeader& header, SimSnapshot& snapshot) {
+    if (size < HEADER_SIZE || std::memcmp(data, MAGIC, sizeof(MAGIC))) {
+        fmt::print("Not a save file!\n");
+        return false;
+    }
+    header.version = (std::uint32_t)get(data + 8, 4);
+    if (header.version != VERSION) {
+        fmt::print("Save file version {} is not supported, expected {}!\n",
+                   header.version, VERSION);
+        return false;
+    }
+    auto headerSize = (std::size_t)get(data + 12, 4);
+    auto savedSize = (std::size_t)get(data + 16, 4);
+    header.width = (std::int32_t)get(data + 20, 4);
+    header.height = (std::int32_t)get(data + 24, 4);
+    header.seed = (std::uint32_t)get(data + 28, 4);
+    header.launchBalls = (std::int32_t)get(data + 32, 4);
+    header.collisionMode = (std::uint8_t)get(data + 36, 1);
+    auto levelCount = (std::size_t)get(data + 40, 4);
+    snapshot.ballCount = (std::int32_t)get(data + 44, 4);
+    snapshot.powerUpCount = (std::int32_t)get(data + 48, 4);
+    snapshot.brickWords = (std::int32_t)get(data + 52, 4);
+    if (headerSize != HEADER_SIZE) {
+        fmt::print("Save file header has {} bytes, expected {}!\n",
+                   headerSize, HEADER_SIZE);
+        return false;
+    }
+    if (savedSize != size) {
+        fmt::print("Save file has {} bytes, expected {}!\n", size,
+                   savedSize);
+        return false;
+    }
+    if (snapshot.ballCount < 1 ||
+        snapshot.ballCount > MAX_SNAPSHOT_BALLS ||
+        snapshot.powerUpCount < 0 ||
+        snapshot.powerUpCount > MAX_SNAPSHOT_POWER_UPS ||
+        snapshot.brickWords < 0 ||
+        snapshot.brickWords > MAX_SNAPSHOT_BRICK_WORDS) {
+        fmt::print("Save file has {} balls, {} power-ups and {} brick "
+                   "words, more than a snapshot holds!\n",
+                   snapshot.ballCount, snapshot.powerUpCount,
+                   snapshot.brickWords);
+        return false;
+    }
+    if (size != fileSize(levelCount, snapshot.ballCount,
+                         snapshot.powerUpCount, snapshot.brickWords)) {
+        fmt::print("Save file size does not match its contents!\n");
+        return false;
+    }
+    if (get(data + CHECKSUM_OFFSET, 8) !=
+        checksum(data + HEADER_SIZE, size - HEADER_SIZE)) {
+        fmt::print("Save file checksum does not match!\n");
+        return false;
+    }
+    if (header.collisionMode > (std::uint8_t)CollisionMode::Swept) {
+        fmt::print("Save file has unknown collision mode {}!\n",
+                   header.collisionMode);
+        return false;
+    }
+    if (header.launchBalls < 1 || header.launchBalls > MAX_LAUNCH_BALLS) {
+        fmt::print("Save file launches {} balls, not 1 to {}!\n",
+                   header.launchBalls, MAX_LAUNCH_BALLS);
+        return false;
+    }
+
+    const std::uint8_t* p = data + HEADER_SIZE;
+    header.levelHashes.clear();
+    for (std::size_t i = 0; i < levelCount; ++i) {
+        header.levelHashes.push_back(get(p, 8));
+        p += 8;
+    }
+
+    snapshot.state = (std::uint8_t)get(p, 1);
+    snapshot.confuse = get(p + 1, 1) != 0;
+    snapshot.chaos = get(p + 2, 1) != 0;
+    snapshot.level = (std::int32_t)get(p + 4, 4);
+    snapshot.lives = (std::int32_t)get(p + 8, 4);
+    snapshot.pendingBalls = (std::int32_t)get(p + 12, 4);
+    snapshot.random.SetState(get(p + 16, 8), get(p + 24, 8));
+    for (int i = 0; i < (int)PowerUpType::Count; ++i) {
+        snapshot.activePowerUps[i] = (std::int32_t)get(p + 32 + 4 * i, 4);
+    }
+    snapshot.playerPosition = getVec2(p + 64);
+    snapshot.playerPreviousPosition = getVec2(p + 72);
+    snapshot.playerSize = getVec2(p + 80);
+    snapshot.playerVelocity = getVec2(p + 88);
+    snapshot.playerColor = getVec3(p + 96);
+    p += STATE_SIZE;
+    if (snapshot.state > (std::uint8_t)GameState::GAME_WIN ||
+        snapshot.level < 0 || snapshot.level >= (int)levelCount) {
+        fmt::print("Save file has game state {} on level {}!\n",
+                   snapshot.state, snapshot.level);
+        return false;
+    }
+    if (snapshot.lives < 0 || snapshot.pendingBalls < 0 ||
+        snapshot.pendingBalls >= header.launchBalls) {
+        fmt::print("Save file has {} lives and {} of {} balls waiting!\n",
+                   snapshot.lives, snapshot.pendingBalls,
+                   header.launchBalls);
+        return false;
+    }
+
+    for (int i = 0; i < snapshot.ballCount; ++i) {
+        auto& ball = snapshot.balls[i];
+        ball.position = getVec2(p);
+        ball.previousPosition = getVec2(p + 8);
+        ball.velocity = getVec2(p + 16);
+        ball.color = getVec3(p + 24);
+        auto flags = (std::uint8_t)get(p + 36, 1);
+        ball.isStatic = flags & SAVED_BALL_STATIC;
+        ball.isSticky = flags & SAVED_BALL_STICKY;
+        ball.isPassThrough = flags & SAVED_BALL_PASS_THROUGH;
+        ball.isAttached = flags & SAVED_BALL_ATTACHED;
+        p += BALL_SIZE;
+    }
+
+    for (int i = 0; i < snapshot.powerUpCount; ++i) {
+        auto& powerUp = snapshot.powerUps[i];
+        powerUp.position = getVec2(p);
+        powerUp.previousPosition = getVec2(p + 8);
+        powerUp.duration = getFloat(p + 16);
+        auto type = (std::uint8_t)get(p + 20, 1);
+        if (type >= (std::uint8_t)PowerUpType::Count) {
+            fmt::print("Save file has unknown power-up type {}!\n", type);
+            return false;
+        }
+        powerUp.type = (PowerUpType)type;
+        auto flags = (std::uint8_t)get(p + 21, 1);
+        powerUp.isActive = flags & SAVED_POWER_UP_ACTIVE;
+        powerUp.isDestroyed = flags & SAVED_POWER_UP_DESTROYED;
+        p += POWER_UP_RECORD_SIZE;
+    }
+    // Each running effect is counted once by its type
+    std::int32_t active[(int)PowerUpType::Count] = {};
+    for (int i = 0; i < snapshot.powerUpCount; ++i) {
+        if (snapshot.powerUps[i].isActive) {
+            ++active[(int)snapshot.powerUps[i].type];
+        }
+    }
+    for (int i = 0; i < (int)PowerUpType::Count; ++i) {
+        if (snapshot.activePowerUps[i] != active[i]) {
+            fmt::print("Save file counts {} running power-ups of type {}, "
+                       "but holds {}!\n",
+                       snapshot.activePowerUps[i], i, active[i]);
+            return false;
+        }
+    }
+
+    for (int i = 0; i < snapshot.brickWords; ++i) {
+        snapshot.destroyedBricks[i] = get(p, 8);
+        p += 8;
+    }
+    if (!IsSnapshotFinite(snapshot)) {
+        fmt::print("Save file holds numbers that are not finite!\n");
+        return false;
+    }
+    return true;
+}
+
+bool IsSnapshotFinite(const SimSnapshot& snapshot) {
+    bool valid = finite(snapshot.playerPosition) &&
+        finite(snapshot.playerPreviousPosition) &&
+        finite(snapshot.playerSize) && finite(snapshot.playerVelocity) &&
+        finite(snapshot.playerColor);
+    for (int i = 0; i < snapshot.ballCount; ++i) {
+        const auto& ball = snapshot.balls[i];
+        valid = valid && finite(ball.position) &&
+            finite(ball.previousPosition) && finite(ball.velocity) &&
+            finite(ball.color);
+    }
+    for (int i = 0; i < snapshot.powerUpCount; ++i) {
+        const auto& powerUp = snapshot.powerUps[i];
+        valid = valid && finite(powerUp.position) &&
+            finite(powerUp.previousPosition) &&
+            std::isfinite(powerUp.duration);
+    }
+    return valid;
+}
+
+bool ApplySaveState(const SaveHeader& header, const SimSnapshot& snapshot,
+                    Simulation& sim) {
+    if (header.width != sim.Width || header.height != sim.Height) {
+        fmt::print("Save was made at {}x{}, not {}x{}!\n",
+                   header.width, header.height, sim.Width, sim.Height);
+        return false;
+    }
+    if ((int)header.levelHashes.size() != sim.GetLevelCount()) {
+        fmt::print("Save was made with {} levels, not {}!\n",
+                   header.levelHashes.size(), sim.GetLevelCount());
+        return false;
+    }
+    for (int i = 0; i < sim.GetLevelCount(); ++i) {
+        if (header.levelHashes[i] != HashLevel(*sim.GetLevelData(i))) {
+            fmt::print("Level {} differs from the saved one!\n", i);
+            return false;
+        }
+    }
+    // Nothing changes unless all of the save can be taken
+    if (!sim.CanRestore(snapshot)) {
+        fmt::print("Save does not fit the loaded levels!\n");
+        return false;
+    }
+    // The seed first, the saved generator state replaces what it sets
+    sim.SetSeed(header.seed);
+    sim.SetCollisionMode((CollisionMode)header.collisionMode);
+    sim.SetLaunchBalls(header.launchBalls);
+    return sim.Restore(snapshot);
+}
+
+bool ReadSaveFile(const std::string& path, std::vector<std::uint8_t>& data) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        fmt::print("Failed opening save file {}!\n", path);
+        return false;
+    }
+    data.resize((std::size_t)file.tellg());
+    file.seekg(0);
+    file.read((char*)data.data(), data.size());
+    if (!file) {
+        fmt::print("Failed reading save file {}!\n", path);
+        return false;
+    }
+    return true;
+}
+
+bool WriteSaveState(const std::string& path, const Simulation& sim) {
+    std::vector<std::uint8_t> data;
+    if (!EncodeSaveState(sim, data)) {
+        return false;
+    }
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write((const char*)data.data(), data.size());
+    if (!file) {
+        fmt::print("Failed writing save file {}!\n", path);
+        return false;
+    }
+    return true;
+}
+
+bool LoadSaveState(const std::string& path, Simulation& sim) {
+    std::vector<std::uint8_t> data;
+    if (!ReadSaveFile(path, data)) {
+        return false;
+    }
+    SaveHeader header;
+    auto snapshot = std::make_unique<SimSnapshot>();
+    return DecodeSaveState(data.data(), data.size(), header, *snapshot) &&
+        ApplySaveState(header, *snapshot, sim);
+}
@@ -0,0 +1,45 @@
+#ifndef __SAVESTATE_H__
+#define __SAVESTATE_H__
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+class Simulation;
+struct SimSnapshot;
+
+// Settings a save was made with, the state itself is a SimSnapshot
+struct SaveHeader {
+    std::uint32_t version = 0;
+    std::int32_t width = 0;
+    std::int32_t height = 0;
+    std::uint32_t seed = 1;
+    std::uint8_t collisionMode = 0;
+    std::int32_t launchBalls = 1;
+    // One per level, in load order, so a save is only loaded on the
+    // levels it was made on
+    std::vector<std::uint64_t> levelHashes;
+};
+
+// Encodes the settings and state of sim in the save format. Fails when
+// the state does not fit a snapshot.
+bool EncodeSaveState(const Simulation& sim, std::vector<std::uint8_t>& out);
+// Decodes a whole save held in memory, read in one go or mapped. Checks
+// the layout, the checksum and the ranges of the values, but not
+// whether the levels match any simulation.
+bool DecodeSaveState(const std::uint8_t* data, std::size_t size,
+                     SaveHeader& header, SimSnapshot& snapshot);
+// Every position, speed, size, color and duration of the snapshot is a
+// finite number. Decoding checks this too.
+bool IsSnapshotFinite(const SimSnapshot& snapshot);
+// Gives sim the settings and state of a decoded save. Fails and changes
+// nothing if the size or the loaded levels differ from the saved ones.
+bool ApplySaveState(const SaveHeader& header, const SimSnapshot& snapshot,
+                    Simulation& sim);
+
+// Reads a file in a single read
+bool ReadSaveFile(const std::string& path, std::vector<std::uint8_t>& data);
+bool WriteSaveState(const std::string& path, const Simulation& sim);
+bool LoadSaveState(const std::string& path, Simulation& sim);
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef __SIMEVENT_H__
+#define __SIMEVENT_H__
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <cstddef>
+#include <vector>
+
+// Things that happened during a simulation step which the frontend
+// may want to react to (sounds, screen effects, statistics).
+enum class SimEventType {
+    BrickDestroyed,
+    SolidBrickHit,
+    PaddleHit,
+    PowerUpCollected,
+    BallLost,
+    LevelComplete,
+    GameOver,
+    Count,
+};
+
+struct SimEvent {
+    SimEventType type;
+    glm::vec2 position;
+};
+
+// Events in the order they happened, for consumers which handle them as
+// one batch after the physics pass. Room for a busy frame is reserved up
+// front, pushing only allocates when that is exceeded. The per-type
+// counts let a consumer react once to many events of the same type.
+class SimEventQueue {
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY = 256;
+
+    explicit SimEventQueue(std::size_t capacity = DEFAULT_CAPACITY) {
+        events.reserve(capacity);
+    }
+
+    void Push(SimEventType type, const glm::vec2& position) {
+        events.push_back({ type, position });
+        ++counts[(int)type];
+    }
+    void Reserve(std::size_t capacity) { events.reserve(capacity); }
+    // Keeps the storage
+    void Clear() {
+        events.clear();
+        for (auto& count : counts) {
+            count = 0;
+        }
+    }
+
+    std::size_t Size() const { return events.size(); }
+    bool Empty() const { return events.empty(); }
+    int Count(SimEventType type) const { return counts[(int)type]; }
+    const SimEvent& operator[](std::size_t i) const { return events[i]; }
+    const SimEvent* begin() const { return events.data(); }
+    const SimEvent* end() const { return events.data() + events.size(); }
+
+private:
+    std::vector<SimEvent> events;
+    int counts[(int)SimEventType::Count] = {};
+};
+
+// How many events of each type any number of steps made, for consumers
+// that never look at the positions. Adding a step costs the same however
+// many events it had and never allocates.
+class SimEventCounts {
+public:
+    void Add(const SimEventQueue& queue) {
+        for (int i = 0; i < (int)SimEventType::Count; ++i) {
+            counts[i] += queue.Count((SimEventType)i);
+        }
+        total += (int)queue.Size();
+    }
+    void Clear() {
+        for (auto& count : counts) {
+            count = 0;
+        }
+        total = 0;
+    }
+
+    bool Empty() const { return total == 0; }
+    int Count(SimEventType type) const { return counts[(int)type]; }
+
+private:
+    int counts[(int)SimEventType::Count] = {};
+    int total = 0;
+};
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef __SIMSNAPSHOT_H__
+#define __SIMSNAPSHOT_H__
+
+#include <cstdint>
+#include <type_traits>
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include "PowerUp.h"
+#include "Random.h"
+
+// Capacity of a SimSnapshot. Regular play stays within them, the
+// multi-ball stress mode can have more balls than fit.
+const int MAX_SNAPSHOT_BALLS = 64;
+const int MAX_SNAPSHOT_POWER_UPS = 256;
+// Bricks of all levels together, each level starts on a new word
+const int MAX_SNAPSHOT_BRICK_WORDS = 64;
+
+struct SnapshotBall {
+    glm::vec2 position;
+    glm::vec2 previousPosition;
+    glm::vec2 velocity;
+    glm::vec3 color;
+    bool isStatic;
+    bool isSticky;
+    bool isPassThrough;
+    // Riding on the paddle
+    bool isAttached;
+};
+
+struct SnapshotPowerUp {
+    glm::vec2 position;
+    glm::vec2 previousPosition;
+    float duration;
+    PowerUpType type;
+    bool isActive;
+    bool isDestroyed;
+};
+
+// Everything a Simulation needs to continue exactly where it was
+// captured, between two steps. Plain data of a fixed size without any
+// pointers, so it can be copied around, kept in a ring buffer for
+// rewinding or compared byte by byte. Settings such as the collision
+// mode, the worker count and the loaded levels are not part of it.
+struct SimSnapshot {
+    std::uint8_t state;
+    bool confuse;
+    bool chaos;
+    std::int32_t level;
+    std::int32_t lives;
+    std::int32_t pendingBalls;
+    Random random;
+    std::int32_t activePowerUps[(int)PowerUpType::Count];
+
+    glm::vec2 playerPosition;
+    glm::vec2 playerPreviousPosition;
+    glm::vec2 playerSize;
+    glm::vec2 playerVelocity;
+    glm::vec3 playerColor;
+
+    std::int32_t ballCount;
+    std::int32_t powerUpCount;
+    // Used words of destroyedBricks, bit i of a level's words is set
+    // when its brick i is destroyed
+    std::int32_t brickWords;
+    SnapshotBall balls[MAX_SNAPSHOT_BALLS];
+    SnapshotPowerUp powerUps[MAX_SNAPSHOT_POWER_UPS];
+    std::uint64_t destroyedBricks[MAX_SNAPSHOT_BRICK_WORDS];
+};
+
+static_assert(std::is_trivially_copyable<SimSnapshot>::value,
+              "snapshots are copied as plain bytes");
+
+#endif
@@ -0,0 +1,1044 @@
+#include "Simulation.h"
+
+#include <memory>
+#include <cmath>
+#include <algorithm>
+
+#include "AllocTracker.h"
+#include "Ball.h"
+#include "GameLevel.h"
+#include "GameObject.h"
+#include "PowerUp.h"
+#include "SimSnapshot.h"
+#include "Sweep.h"
+#include "WorkerPool.h"
+
+const glm::vec2 BALL_VELOCITY = glm::vec2(200.0f, -200.0f);
+const glm::vec2 PLAYER_SIZE = glm::vec2(100.0f, 20.0f);
+// Contacts resolved per step in swept mode, motion left after that is
+// dropped
+const int MAX_SWEEP_BOUNCES = 4;
+// Fewer brick candidates than this are tested one by one
+const std::size_t KERNEL_MIN_BATCH = 16;
+// Power-ups falling or in effect at once, drops beyond are skipped
+const int MAX_POWER_UPS = 256;
+static_assert(MAX_POWER_UPS <= MAX_SNAPSHOT_POWER_UPS,
+              "every power-up has to fit a snapshot");
+// Balls handed to a worker at a time
+const int BALL_GRAIN = 32;
+// The split power-up stops adding balls beyond this
+const std::size_t MAX_SPLIT_BALLS = 64;
+static_assert(MAX_SPLIT_BALLS <= MAX_SNAPSHOT_BALLS,
+              "split balls have to fit a snapshot");
+// Angle between a split ball and the ones it splits off, in radians
+const float SPLIT_ANGLE = 0.35f;
+// Contacts a ball has room for before its list grows, more than a ball
+// touches in one step
+const std::size_t BALL_CONTACT_CAPACITY = 8;
+
+Simulation::Simulation(int width, int height)
+    : Width(width)
+    , Height(height)
+    , powerUps(entities, MAX_POWER_UPS) {
+    // Player
+    GameObjectAttribute attr;
+    attr.size = PLAYER_SIZE;
+    attr.position = glm::vec2(this->Width / 2 - attr.size.x / 2,
+                              this->Height - attr.size.y);
+    attr.velocity = glm::vec2(0.0f, 0.0f);
+    attr.color = glm::vec3(1.0f, 1.0f, 1.0f);
+    attr.rotation = 0;
+    attr.isSolid = true;
+    attr.isDestroyed = false;
+    attr.sprite = Sprite::Paddle;
+    player = std::make_unique<GameObject>(entities, attr);
+    objects.push_back(player.get());
+
+    // Ball
+    BallAttribute ballAttr;
+    ballAttr.radius = 10.0f;
+    ballAttr.isStatic = true;
+
+    ballAttr.size = glm::vec2(2 * ballAttr.radius);
+    ballAttr.position = player->Position() +
+        glm::vec2(player->Size().x / 2 - ballAttr.radius,
+                  -2 * ballAttr.radius - 1.0f);
+    ballAttr.velocity = BALL_VELOCITY;
+    ballAttr.color = glm::vec3(1.0f);
+    ballAttr.rotation = 0.0f;
+    ballAttr.isSolid = true;
+    ballAttr.isDestroyed = false;
+    ballAttr.sprite = Sprite::Face;
+    balls.push_back(std::make_unique<Ball>(entities, ballAttr));
+    player->Attach(balls.front().get());
+
+    // Boundary
+    attr.size = glm::vec2(Width, 1.0f);
+    attr.position = glm::vec2(0.0f, -1.0f);
+    attr.isSolid = true;
+    attr.isDestroyed = false;
+    attr.sprite = Sprite::None;
+    boundary.emplace_back(std::make_unique<GameObject>(entities, attr));
+
+    attr.size = glm::vec2(1.0f, Height);
+    attr.position = glm::vec2(-1.0f, 0.0f);
+    boundary.emplace_back(std::make_unique<GameObject>(entities, attr));
+
+    attr.position = glm::vec2(Width, 0.0f);
+    boundary.emplace_back(std::make_unique<GameObject>(entities, attr));
+}
+
+Simulation::~Simulation() { }
+
+int Simulation::GetWorkerCount() const {
+    return workers ? workers->Workers() : 1;
+}
+
+void Simulation::SetWorkerCount(int count) {
+    count = std::max(count, 1);
+    if (count == GetWorkerCount()) {
+        return;
+    }
+    workers = count > 1 ? std::make_unique<WorkerPool>(count) : nullptr;
+}
+
+void Simulation::SetSeed(std::uint32_t seed) {
+    this->seed = seed;
+    random.Seed(seed, RandomStream::Gameplay);
+}
+
+bool Simulation::LoadLevel(const std::string& path) {
+    return LoadLevel(LevelData::Load(path));
+}
+
+bool Simulation::LoadLevel(std::shared_ptr<const LevelData> data) {
+    auto newLevel = std::make_unique<GameLevel>();
+    if (!newLevel->Load(std::move(data), this->Width, this->Height / 2)) {
+        return false;
+    }
+    levels.push_back(std::move(newLevel));
+    return true;
+}
+
+const GameLevel* Simulation::GetLevel() const {
+    return levels.empty() ? nullptr : levels[level].get();
+}
+
+const LevelData* Simulation::GetLevelData(int index) const {
+    return levels[index]->GetData();
+}
+
+bool Simulation::Capture(SimSnapshot& snapshot) const {
+    const auto& active = powerUps.Active();
+    if (balls.size() > MAX_SNAPSHOT_BALLS ||
+        active.size() > MAX_SNAPSHOT_POWER_UPS) {
+        return false;
+    }
+    int brickWords = 0;
+    for (const auto& l : levels) {
+        brickWords += l->BrickWords();
+    }
+    if (brickWords > MAX_SNAPSHOT_BRICK_WORDS) {
+        return false;
+    }
+
+    snapshot.state = (std::uint8_t)State;
+    snapshot.confuse = effects.confuse;
+    snapshot.chaos = effects.chaos;
+    snapshot.level = level;
+    snapshot.lives = play_ball;
+    snapshot.pendingBalls = pendingBalls;
+    snapshot.random = random;
+    for (int i = 0; i < (int)PowerUpType::Count; ++i) {
+        snapshot.activePowerUps[i] = activePowerUps[i];
+    }
+
+    snapshot.playerPosition = player->Position();
+    snapshot.playerPreviousPosition =
+        entities.previousPositions[player->Index()];
+    snapshot.playerSize = player->Size();
+    snapshot.playerVelocity = player->Velocity();
+    snapshot.playerColor = player->Color();
+
+    snapshot.ballCount = (std::int32_t)balls.size();
+    for (std::size_t i = 0; i < balls.size(); ++i) {
+        const Ball* ball = balls[i].get();
+        auto& saved = snapshot.balls[i];
+        saved.position = ball->Position();
+        saved.previousPosition = entities.previousPositions[ball->Index()];
+        saved.velocity = ball->Velocity();
+        saved.color = ball->Color();
+        saved.isStatic = ball->isStatic;
+        saved.isSticky = ball->isSticky;
+        saved.isPassThrough = ball->isPassThrough;
+        saved.isAttached = ball->Parent() == player.get();
+    }
+
+    snapshot.powerUpCount = (std::int32_t)active.size();
+    for (std::size_t i = 0; i < active.size(); ++i) {
+        const PowerUp* p = active[i];
+        auto& saved = snapshot.powerUps[i];
+        saved.position = p->Position();
+        saved.previousPosition = entities.previousPositions[p->Index()];
+        saved.duration = p->duration;
+        saved.type = p->type;
+        saved.isActive = p->isActive;
+        saved.isDestroyed = p->IsDestroyed();
+    }
+
+    snapshot.brickWords = brickWords;
+    std::uint64_t* bits = snapshot.destroyedBricks;
+    for (const auto& l : levels) {
+        l->SaveDestroyed(bits);
+        bits += l->BrickWords();
+    }
+    return true;
+}
+
+bool Simulation::CanRestore(const SimSnapshot& snapshot) const {
+    int brickWords = 0;
+    for (const auto& l : levels) {
+        brickWords += l->BrickWords();
+    }
+    return brickWords == snapshot.brickWords &&
+        snapshot.level >= 0 && snapshot.level < GetLevelCount() &&
+        snapshot.ballCount >= 1 &&
+        snapshot.ballCount <= MAX_SNAPSHOT_BALLS &&
+        snapshot.powerUpCount >= 0 &&
+        snapshot.powerUpCount <= MAX_SNAPSHOT_POWER_UPS;
+}
+
+bool Simulation::Restore(const SimSnapshot& snapshot) {
+    if (!CanRestore(snapshot)) {
+        return false;
+    }
+
+    State = (GameState)snapshot.state;
+    effects.confuse = snapshot.confuse;
+    effects.chaos = snapshot.chaos;
+    level = snapshot.level;
+    play_ball = snapshot.lives;
+    pendingBalls = snapshot.pendingBalls;
+    random = snapshot.random;
+    for (int i = 0; i < (int)PowerUpType::Count; ++i) {
+        activePowerUps[i] = snapshot.activePowerUps[i];
+    }
+
+    player->Position() = snapshot.playerPosition;
+    entities.previousPositions[player->Index()] =
+        snapshot.playerPreviousPosition;
+    player->Size() = snapshot.playerSize;
+    player->Velocity() = snapshot.playerVelocity;
+    player->Color() = snapshot.playerColor;
+
+    // The first ball is never released, the others come from and go to
+    // the spare balls
+    while ((int)balls.size() > snapshot.ballCount) {
+        releaseBall(std::move(balls.back()));
+        balls.pop_back();
+    }
+    while ((int)balls.size() < snapshot.ballCount) {
+        spawnBall(balls.front().get(), glm::vec2(0.0f));
+    }
+    for (auto& ball : balls) {
+        player->Detach(ball.get());
+    }
+    for (std::size_t i = 0; i < balls.size(); ++i) {
+        Ball* ball = balls[i].get();
+        const auto& saved = snapshot.balls[i];
+        ball->Position() = saved.position;
+        entities.previousPositions[ball->Index()] = saved.previousPosition;
+        ball->Velocity() = saved.velocity;
+        ball->Color() = saved.color;
+        ball->isStatic = saved.isStatic;
+        ball->isSticky = saved.isSticky;
+        ball->isPassThrough = saved.isPassThrough;
+        if (saved.isAttached) {
+            player->Attach(ball);
+        }
+    }
+
+    // Power-ups take whatever slots are free, only their order matters
+    powerUps.Clear();
+    for (int i = 0; i < snapshot.powerUpCount; ++i) {
+        const auto& saved = snapshot.powerUps[i];
+        PowerUp* p = powerUps.Get(powerUps.Spawn(saved.type, saved.position));
+        entities.previousPositions[p->Index()] = saved.previousPosition;
+        p->duration = saved.duration;
+        p->isActive = saved.isActive;
+        p->SetDestroyed(saved.isDestroyed);
+    }
+
+    const std::uint64_t* bits = snapshot.destroyedBricks;
+    for (auto& l : levels) {
+        l->RestoreDestroyed(bits);
+        bits += l->BrickWords();
+    }
+    reserveBalls();
+    events.Clear();
+    return true;
+}
+
+void Simulation::ProcessInput(const InputState& input) {
+    if (State == GameState::GAME_ACTIVE) {
+        auto& playerVelocity = player->Velocity();
+        if (input.left == input.right) {
+            playerVelocity.x = 0.0f;
+        } else if (input.left) {
+            playerVelocity.x = -500.0f;
+        } else {
+            playerVelocity.x = 500.0f;
+        }
+
+        if (input.launch) {
+            launchBalls();
+        }
+
+        if (input.skipLevel) {
+            effects.chaos = true;
+            State = GameState::GAME_WIN;
+        }
+    } else if (State == GameState::GAME_MENU) {
+        int count = GetLevelCount();
+        if (input.prevLevel && count) {
+            level = (level - 1 + count) % count;
+        }
+        if (input.nextLevel && count) {
+            level = (level + 1) % count;
+        }
+        if (input.confirm && count) {
+            State = GameState::GAME_ACTIVE;
+            reset_player();
+            reset_ball();
+            clear_powerups();
+            play_ball = 2;
+        }
+    } else if (State == GameState::GAME_WIN) {
+        if (input.confirm) {
+            reset_level();
+            effects.chaos = false;
+            State = GameState::GAME_MENU;
+        }
+    }
+}
+
+void Simulation::Update(float dt) {
+    ALLOC_SCOPE("Simulation::Update");
+    events.Clear();
+    if (State == GameState::GAME_ACTIVE) {
+        storePreviousPositions();
+        for (auto& object : objects) {
+            object->Update(dt);
+        }
+        moveBalls(dt);
+        dropPowerUps();
+        doCollision();
+
+        updatePowerUps(dt);
+
+        if (dropLostBalls()) {
+            --play_ball;
+            if (play_ball >= 0) {
+                reset_player();
+                reset_ball();
+            } else {
+                State = GameState::GAME_MENU;
+                emit(SimEventType::GameOver, balls.front()->Position());
+            }
+        }
+
+        if (levels[level]->IsComplete()) {
+            State = GameState::GAME_WIN;
+            effects.chaos = true;
+            emit(SimEventType::LevelComplete, balls.front()->Position());
+        }
+    }
+}
+
+void Simulation::storePreviousPositions() {
+    entities.previousPositions = entities.positions;
+}
+
+void Simulation::emit(SimEventType type, const glm::vec2& position) {
+    events.Push(type, position);
+}
+
+void Simulation::moveBalls(float dt) {
+    if (contacts.size() < balls.size()) {
+        contacts.resize(balls.size());
+    }
+    int workerCount = GetWorkerCount();
+    if ((int)workspaces.size() < workerCount) {
+        workspaces.resize(workerCount);
+    }
+
+    // Each ball only reads the level and writes itself, so the balls can
+    // be spread over the workers in any way
+    auto job = [this, dt](int begin, int end, int worker) {
+        ALLOC_SCOPE("Simulation::moveBalls");
+        auto& work = workspaces[worker];
+        for (int i = begin; i < end; ++i) {
+            Ball* ball = balls[i].get();
+            auto& hits = contacts[i];
+            hits.clear();
+            ball->Update(dt);
+            if (collisionMode == CollisionMode::Swept && !ball->isStatic) {
+                sweepBall(ball, work, hits);
+            } else {
+                collideBall(ball, work, hits);
+            }
+        }
+    };
+    if (workers) {
+        workers->ParallelFor((int)balls.size(), BALL_GRAIN, job);
+    } else {
+        job(0, (int)balls.size(), 0);
+    }
+
+    resolveContacts();
+}
+
+void Simulation::resolveContacts() {
+    // Ball order, not finishing order, decides which ball gets a brick
+    for (std::size_t i = 0; i < balls.size(); ++i) {
+        Ball* ball = balls[i].get();
+        for (const auto& contact : contacts[i]) {
+            if (contact.type == ContactType::Brick) {
+                hitBrick(contact.brick);
+            } else {
+                if (ball->isStatic) {
+                    player->Attach(ball);
+                }
+                emit(SimEventType::PaddleHit, contact.position);
+            }
+        }
+    }
+}
+
+void Simulation::doCollision() {
+    // Power up VS Player
+    for (PowerUp* p : powerUps.Active()) {
+        if (p->IsDestroyed()) {
+            continue;
+        }
+        if (p->Position().y >= Height) {
+            p->SetDestroyed(true);
+            continue;
+        }
+        if (checkCollision(player.get(), p)) {
+            activatePowerUp(p);
+            p->SetDestroyed(true);
+            emit(SimEventType::PowerUpCollected, p->Position());
+        }
+    }
+}
+
+void Simulation::collideBall(Ball* ball, BallWorkspace& work,
+                             std::vector<BallContact>& hits) const {
+    // Ball VS Bricks, only those near the path the ball took this step.
+    // The margin covers the push out of a brick, which can move the ball
+    // by up to its radius before the next brick is tested.
+    auto& bricks = levels[level]->bricks;
+    glm::vec2 center = ball->Position() + glm::vec2(ball->radius);
+    glm::vec2 previousCenter = entities.previousPositions[ball->Index()] +
+        glm::vec2(ball->radius);
+    glm::vec2 margin = glm::vec2(2.0f * ball->radius);
+    queryBricks(work, glm::min(center, previousCenter) - margin,
+                glm::max(center, previousCenter) + margin);
+    const auto& candidates = work.brickCandidates;
+
+    // Rule out the far candidates in one batch. The exact test below
+    // still runs for the rest, so the outcome does not depend on the
+    // kernel.
+    bool filtered = collisionKernel != KernelIsa::Scalar &&
+        candidates.size() >= KERNEL_MIN_BATCH;
+    if (filtered) {
+        work.candidateBoxes.Clear();
+        for (auto i : candidates) {
+            glm::vec2 min = bricks.positions[i];
+            glm::vec2 max = min + bricks.sizes[i];
+            work.candidateBoxes.Add(min.x, min.y, max.x, max.y);
+        }
+        CircleVsBoxes(collisionKernel, center.x, center.y,
+                      ball->radius * 1.001f + 0.01f,
+                      work.candidateBoxes, work.candidateHits);
+    }
+
+    bool moved = false;
+    for (std::size_t k = 0; k < candidates.size(); ++k) {
+        // The batch result is stale once a collision moved the ball
+        if (filtered && !moved && !work.candidateHits.Hit((int)k)) {
+            continue;
+        }
+        auto i = candidates[k];
+        auto info = checkCollision(ball, bricks.positions[i],
+                                   bricks.sizes[i]);
+        if (info.isCollided) {
+            hits.push_back({ ContactType::Brick, i, ball->Position() });
+            if (bouncesOffBrick(ball, i)) {
+                applyCollision(ball, info);
+                moved = true;
+            }
+        }
+    }
+
+    // Ball VS Boundary
+    for (auto& bound : boundary) {
+        auto info = checkCollision(ball, bound->Position(),
+                                   bound->Size());
+        if (info.isCollided) {
+            applyCollision(ball, info);
+        }
+    }
+
+    // Ball VS Player
+    auto info = checkCollision(ball, player->Position(),
+                               player->Size());
+    if (!ball->isStatic && info.isCollided) {
+        bouncePlayer(ball);
+        hits.push_back({ ContactType::Player, 0, ball->Position() });
+    }
+}
+
+void Simulation::sweepBall(Ball* ball, BallWorkspace& work,
+                           std::vector<BallContact>& hits) const {
+    // Sweep from where the ball started this step, Update has already
+    // moved it to the end of its unobstructed path
+    glm::vec2 offset = glm::vec2(ball->radius);
+    glm::vec2 center = entities.previousPositions[ball->Index()] + offset;
+    glm::vec2 motion = ball->Position() + offset - center;
+
+    // Bounces never carry the ball further than the path length
+    float reach = glm::length(motion) + 2.0f * ball->radius;
+    queryBricks(work, center - glm::vec2(reach), center + glm::vec2(reach));
+
+    // Bricks are destroyed after the pass, the ones this ball already
+    // broke are skipped here
+    auto& bricks = levels[level]->bricks;
+    auto broken = [&](EntityStore::Index brick) {
+        if (bricks.HasFlag(brick, ENTITY_SOLID)) {
+            return false;
+        }
+        for (const auto& hit : hits) {
+            if (hit.type == ContactType::Brick && hit.brick == brick) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    const float SKIN = 1e-3f;
+    for (int bounce = 0; bounce < MAX_SWEEP_BOUNCES; ++bounce) {
+        // Earliest contact, ties keep the first one found
+        enum class Target { None, Brick, Boundary, Player };
+        Target target = Target::None;
+        EntityStore::Index brick = 0;
+        SweepHit best;
+        best.time = 2.0f;
+        SweepHit hit;
+
+        for (auto i : work.brickCandidates) {
+            if (bricks.IsAlive(i) &&
+                SweepCircleBox(center, motion, ball->radius,
+                               bricks.positions[i],
+                               bricks.positions[i] + bricks.sizes[i],
+                               hit) &&
+                hit.time < best.time && !broken(i)) {
+                best = hit;
+                target = Target::Brick;
+                brick = i;
+            }
+        }
+        for (auto& bound : boundary) {
+            if (SweepCircleBox(center, motion, ball->radius,
+                               bound->Position(),
+                               bound->Position() + bound->Size(), hit) &&
+                hit.time < best.time) {
+                best = hit;
+                target = Target::Boundary;
+            }
+        }
+        if (SweepCircleBox(center, motion, ball->radius,
+                           player->Position(),
+                           player->Position() + player->Size(), hit) &&
+            hit.time < best.time) {
+            best = hit;
+            target = Target::Player;
+        }
+
+        if (target == Target::None) {
+            center += motion;
+            break;
+        }
+
+        center += motion * best.time + best.normal * SKIN;
+        float remaining = glm::length(motion) * (1.0f - best.time);
+        ball->Position() = center - offset;
+
+        bool reflect = true;
+        if (target == Target::Brick) {
+            reflect = bouncesOffBrick(ball, brick);
+            hits.push_back({ ContactType::Brick, brick, ball->Position() });
+        } else if (target == Target::Player) {
+            bouncePlayer(ball);
+            hits.push_back({ ContactType::Player, 0, ball->Position() });
+            if (ball->isStatic) {
+                return;
+            }
+            reflect = false;
+        }
+        if (reflect) {
+            glm::vec2& velocity = ball->Velocity();
+            velocity -= 2.0f * glm::dot(velocity, best.normal) * best.normal;
+        }
+
+        // Spend the rest of the step along the new direction
+        float speed = glm::length(ball->Velocity());
+        motion = speed > 0.0f ?
+            ball->Velocity() * (remaining / speed) : glm::vec2(0.0f);
+        if (bounce == MAX_SWEEP_BOUNCES - 1) {
+            motion = glm::vec2(0.0f);
+        }
+    }
+    ball->Position() = center - offset;
+}
+
+void Simulation::queryBricks(BallWorkspace& work, glm::vec2 min,
+                             glm::vec2 max) const {
+    work.brickCandidates.clear();
+    levels[level]->grid.Query(min, max, work.brickCandidates);
+    // Keep the order of a full scan, the result depends on it
+    std::sort(work.brickCandidates.begin(), work.brickCandidates.end());
+}
+
+bool Simulation::bouncesOffBrick(const Ball* ball,
+                                 EntityStore::Index brick) const {
+    return levels[level]->bricks.HasFlag(brick, ENTITY_SOLID) ||
+        !ball->isPassThrough;
+}
+
+void Simulation::hitBrick(EntityStore::Index brick) {
+    auto& currentLevel = *levels[level];
+    auto& bricks = currentLevel.bricks;
+    if (bricks.HasFlag(brick, ENTITY_SOLID)) {
+        emit(SimEventType::SolidBrickHit, bricks.positions[brick]);
+        return;
+    }
+    // Every ball that reached the brick in this step bounced off it,
+    // only the first one breaks it
+    if (!bricks.IsAlive(brick)) {
+        return;
+    }
+    currentLevel.DestroyBrick(brick);
+    emit(SimEventType::BrickDestroyed, bricks.positions[brick]);
+}
+
+void Simulation::bouncePlayer(Ball* ball) const {
+    float playerCenter = player->Position().x +
+        player->Size().x / 2.0f;
+    float dist = ball->Position().x +
+        ball->radius - playerCenter;
+    float percent = dist / (player->Size().x / 2.0f);
+    percent = glm::clamp(percent, -1.0f, 1.0f);
+    glm::vec2 oldVelocity = ball->Velocity();
+    ball->Velocity().x = BALL_VELOCITY.x * percent * 2.0f;
+    ball->Velocity() =
+        glm::normalize(ball->Velocity()) *
+        glm::length(oldVelocity);
+    ball->Velocity().y = -1.0f *
+        std::fabs(ball->Velocity().y);
+    if (ball->isSticky) {
+        ball->isStatic = true;
+    }
+}
+
+bool Simulation::checkCollision(const GameObject* obj1,
+                                const GameObject* obj2) const {
+    bool collisionX =
+        obj1->Position().x + obj1->Size().x >=
+        obj2->Position().x &&
+        obj2->Position().x + obj2->Size().x >=
+        obj1->Position().x;
+    bool collisionY =
+        obj1->Position().y + obj1->Size().y >=
+        obj2->Position().y &&
+        obj2->Position().y + obj2->Size().y >=
+        obj1->Position().y;
+    return collisionX && collisionY;
+}
+
+CollisionInfo
+Simulation::checkCollision(const Ball* ball,
+                           const glm::vec2& position,
+                           const glm::vec2& size) const {
+    glm::vec2 ballCenter = ball->Position() +
+        glm::vec2(ball->radius);
+    glm::vec2 halfSize = size * 0.5f;
+    glm::vec2 brickCenter = position + halfSize;
+    glm::vec2 dist = ballCenter - brickCenter;
+    glm::vec2 closest = glm::clamp(dist, -halfSize, halfSize) +
+        brickCenter;
+
+    dist = closest - ballCenter;
+
+    CollisionInfo info;
+    info.isCollided = glm::length(dist) < ball->radius;
+    info.direction= info.isCollided ?
+        calculateCollisionDirection(dist) :
+        glm::vec2(1.0f);
+    info.displace = dist;
+
+    return info;
+}
+
+glm::vec2
+Simulation::calculateCollisionDirection(const glm::vec2& dir) const {
+    static glm::vec2 compass[] = {
+        glm::vec2(0.0f, 1.0f),
+        glm::vec2(1.0f, 0.0f),
+        glm::vec2(0.0f, -1.0f),
+        glm::vec2(-1.0f, 0.0f),
+    };
+    float max = 0.0f;
+    int best = -1;
+    for (int i = 0; i < 4; ++i) {
+        float dotProduct = glm::dot(glm::normalize(compass[i]), dir);
+        if (dotProduct > max) {
+            max = dotProduct;
+            best = i;
+        }
+    }
+    return compass[best];
+}
+
+void Simulation::applyCollision(Ball* ball,
+                                const CollisionInfo& info) const {
+    if (info.direction == glm::vec2(1.0f, 0.0f) ||
+        info.direction == glm::vec2(-1.0f, 0.0f)) {
+        ball->Velocity().x *= -1.0f;
+        float penetration = ball->radius -
+            std::fabs(info.displace.x);
+        ball->Position().x += info.direction.x == 1.0f ?
+            -penetration : +penetration;
+    } else {
+        ball->Velocity().y *= -1.0f;
+        float penetration = ball->radius -
+            std::fabs(info.displace.y);
+        ball->Position().y += info.direction.y == 1.0f ?
+            -penetration : penetration;
+    }
+}
+
+bool Simulation::shouldSpawn(int chance) {
+    return random.Below(chance) == 0;
+}
+
+const Simulation::PowerUpHooks Simulation::powerUpHooks[] = {
+    { &Simulation::activateSpeed, nullptr },
+    { &Simulation::activateSticky, &Simulation::deactivateSticky },
+    { &Simulation::activatePassThrough, &Simulation::deactivatePassThrough },
+    { &Simulation::activatePadSizeIncrease, nullptr },
+    { &Simulation::activateConfuse, &Simulation::deactivateConfuse },
+    { &Simulation::activateChaos, &Simulation::deactivateChaos },
+    { &Simulation::splitBalls, nullptr },
+};
+
+void Simulation::spawnPowerUps(glm::vec2 position) {
+    for (int i = 0; i < (int)PowerUpType::Count; ++i) {
+        const auto& info = GetPowerUpInfo((PowerUpType)i);
+        if (shouldSpawn(info.spawnChance)) {
+            powerUps.Spawn((PowerUpType)i, position);
+        }
+    }
+}
+
+void Simulation::dropPowerUps() {
+    if (!events.Count(SimEventType::BrickDestroyed)) {
+        return;
+    }
+    for (const auto& event : events) {
+        if (event.type == SimEventType::BrickDestroyed) {
+            spawnPowerUps(event.position);
+        }
+    }
+}
+
+void Simulation::activatePowerUp(PowerUp* p) {
+    static_assert(sizeof(powerUpHooks) / sizeof(powerUpHooks[0]) ==
+                  (std::size_t)PowerUpType::Count,
+                  "every power-up type needs hooks");
+    auto activate = powerUpHooks[(int)p->type].activate;
+    if (activate) {
+        (this->*activate)();
+    }
+    p->isActive = true;
+    ++activePowerUps[(int)p->type];
+}
+
+void Simulation::updatePowerUps(float dt) {
+    // Every effect that runs out ends here
+    for (PowerUp* p : powerUps.Active()) {
+        bool wasActive = p->isActive;
+        p->Update(dt);
+        if (wasActive && !p->isActive) {
+            onPowerUpEnd(p);
+        }
+    }
+    powerUps.ReleaseIf([](const PowerUp& p) {
+        return p.IsDestroyed() && !p.isActive;
+    });
+}
+
+void Simulation::onPowerUpEnd(const PowerUp* p) {
+    --activePowerUps[(int)p->type];
+    auto deactivate = powerUpHooks[(int)p->type].deactivate;
+    if (deactivate) {
+        (this->*deactivate)();
+    }
+}
+
+void Simulation::activateSpeed() {
+    for (auto& ball : balls) {
+        ball->Velocity() *= 1.2;
+    }
+}
+
+void Simulation::activateSticky() {
+    for (auto& ball : balls) {
+        ball->isSticky = true;
+    }
+    player->Color() = glm::vec3(1.0f, 0.5f, 1.0f);
+}
+
+void Simulation::deactivateSticky() {
+    for (auto& ball : balls) {
+        ball->isSticky = false;
+    }
+    player->Color() = glm::vec3(1.0f);
+}
+
+void Simulation::activatePassThrough() {
+    for (auto& ball : balls) {
+        ball->isPassThrough = true;
+        ball->Color() = glm::vec3(1.0f, 0.5f, 0.5f);
+    }
+}
+
+void Simulation::deactivatePassThrough() {
+    for (auto& ball : balls) {
+        ball->isPassThrough = false;
+        ball->Color() = glm::vec3(1.0f);
+    }
+}
+
+void Simulation::activatePadSizeIncrease() {
+    player->Size().x += 50;
+}
+
+void Simulation::activateConfuse() {
+    if (!effects.chaos) {
+        effects.confuse = true;
+    }
+}
+
+void Simulation::deactivateConfuse() {
+    if (!activePowerUps[(int)PowerUpType::Confuse]) {
+        effects.confuse = false;
+    }
+}
+
+void Simulation::activateChaos() {
+    if (!effects.confuse) {
+        effects.chaos = true;
+    }
+}
+
+void Simulation::deactivateChaos() {
+    if (!activePowerUps[(int)PowerUpType::Chaos]) {
+        effects.chaos = false;
+    }
+}
+
+void Simulation::reset_player() {
+    player->Size() = PLAYER_SIZE;
+    player->Position() = glm::vec2(
+        Width / 2.0f - player->Size().x / 2.0f,
+        Height  - player->Size().y
+        );
+    entities.previousPositions[player->Index()] = player->Position();
+}
+
+void Simulation::reset_ball() {
+    // The first ball stays and keeps the power-ups it carries
+    while (balls.size() > 1) {
+        releaseBall(std::move(balls.back()));
+        balls.pop_back();
+    }
+    auto& ball = balls.front();
+    ball->Velocity() = BALL_VELOCITY;
+    ball->Position() = glm::vec2(
+        player->Position().x + player->Size().x / 2.0f -
+        ball->Size().x / 2.0f,
+        player->Position().y - ball->Size().y
+        );
+    entities.previousPositions[ball->Index()] = ball->Position();
+    ball->isStatic = true;
+    player->Attach(ball.get());
+    pendingBalls = launchCount - 1;
+    reserveBalls();
+}
+
+void Simulation::reserveBalls() {
+    std::size_t most = std::max(MAX_SPLIT_BALLS, (std::size_t)launchCount);
+    balls.reserve(most);
+    spareBalls.reserve(most);
+    while (balls.size() + spareBalls.size() < most) {
+        auto ball = makeBall(balls.front().get());
+        ball->SetDestroyed(true);
+        spareBalls.push_back(std::move(ball));
+    }
+
+    if (contacts.size() < most) {
+        contacts.resize(most);
+    }
+    for (auto& list : contacts) {
+        list.reserve(BALL_CONTACT_CAPACITY);
+    }
+    // Every contact can become an event, on top of that each ball can
+    // be lost and each power-up collected
+    events.Reserve(most * (BALL_CONTACT_CAPACITY + 1) + MAX_POWER_UPS +
+                   SimEventQueue::DEFAULT_CAPACITY);
+
+    // A query never returns more than all bricks of a level
+    int bricks = 0;
+    for (const auto& l : levels) {
+        bricks = std::max(bricks, (int)l->bricks.Size());
+    }
+    int workerCount = GetWorkerCount();
+    if ((int)workspaces.size() < workerCount) {
+        workspaces.resize(workerCount);
+    }
+    for (auto& work : workspaces) {
+        work.brickCandidates.reserve(bricks);
+        work.candidateBoxes.Reserve(bricks);
+        work.candidateHits.Reserve(bricks);
+    }
+}
+
+Ball* Simulation::spawnBall(const Ball* source, const glm::vec2& velocity) {
+    std::unique_ptr<Ball> ball;
+    if (!spareBalls.empty()) {
+        ball = std::move(spareBalls.back());
+        spareBalls.pop_back();
+        ball->SetDestroyed(false);
+    } else {
+        ball = makeBall(source);
+    }
+    ball->Position() = source->Position();
+    entities.previousPositions[ball->Index()] = ball->Position();
+    ball->Velocity() = velocity;
+    ball->Color() = source->Color();
+    ball->isStatic = false;
+    ball->isSticky = source->isSticky;
+    ball->isPassThrough = source->isPassThrough;
+    balls.push_back(std::move(ball));
+    return balls.back().get();
+}
+
+std::unique_ptr<Ball> Simulation::makeBall(const Ball* source) {
+    BallAttribute attr;
+    attr.radius = source->radius;
+    attr.size = source->Size();
+    attr.sprite = Sprite::Face;
+    attr.isSolid = true;
+    return std::make_unique<Ball>(entities, attr);
+}
+
+void Simulation::releaseBall(std::unique_ptr<Ball> ball) {
+    player->Detach(ball.get());
+    ball->SetDestroyed(true);
+    spareBalls.push_back(std::move(ball));
+}
+
+void Simulation::launchBalls() {
+    bool launched = false;
+    for (auto& ball : balls) {
+        if (ball->isStatic) {
+            ball->isStatic = false;
+            player->Detach(ball.get());
+            launched = true;
+        }
+    }
+    if (!launched || pendingBalls <= 0) {
+        return;
+    }
+
+    // Fan the extra balls out over the upper half circle
+    const Ball* first = balls.front().get();
+    float speed = glm::length(first->Velocity());
+    int count = pendingBalls;
+    pendingBalls = 0;
+    for (int i = 1; i <= count; ++i) {
+        float angle = -3.14159265f * (float)i / (count + 1);
+        spawnBall(first, speed * glm::vec2(std::cos(angle),
+                                           std::sin(angle)));
+    }
+}
+
+void Simulation::splitBalls() {
+    std::size_t count = balls.size();
+    float c = std::cos(SPLIT_ANGLE);
+    float s = std::sin(SPLIT_ANGLE);
+    for (std::size_t i = 0; i < count; ++i) {
+        if (balls.size() + 2 > MAX_SPLIT_BALLS) {
+            break;
+        }
+        if (balls[i]->isStatic) {
+            continue;
+        }
+        glm::vec2 v = balls[i]->Velocity();
+        spawnBall(balls[i].get(), glm::vec2(c * v.x - s * v.y,
+                                            s * v.x + c * v.y));
+        spawnBall(balls[i].get(), glm::vec2(c * v.x + s * v.y,
+                                            -s * v.x + c * v.y));
+    }
+}
+
+bool Simulation::dropLostBalls() {
+    auto lost = [this](const std::unique_ptr<Ball>& ball) {
+        return ball->Position().y > Height + 200;
+    };
+    bool allLost = std::all_of(balls.begin(), balls.end(), lost);
+
+    // Keep the order of the others, it decides who gets a brick first
+    std::size_t live = 0;
+    for (std::size_t i = 0; i < balls.size(); ++i) {
+        if (!lost(balls[i])) {
+            balls[live++] = std::move(balls[i]);
+            continue;
+        }
+        emit(SimEventType::BallLost, balls[i]->Position());
+        // The last ball is kept for reset_ball
+        if (allLost && i == 0) {
+            balls[live++] = std::move(balls[i]);
+        } else {
+            releaseBall(std::move(balls[i]));
+        }
+    }
+    balls.resize(live);
+    return allLost;
+}
+
+void Simulation::clear_powerups() {
+    for (PowerUp* p : powerUps.Active()) {
+        if (p->isActive) {
+            p->isActive = false;
+            onPowerUpEnd(p);
+        }
+    }
+    powerUps.Clear();
+}
+
+void Simulation::reset_level() {
+    levels[level]->Reset();
+}
@@ -0,0 +1,264 @@
+#ifndef __SIMULATION_H__
+#define __SIMULATION_H__
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <cstdint>
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include "CollisionKernel.h"
+#include "EntityStore.h"
+#include "Input.h"
+#include "PowerUp.h"
+#include "PowerUpPool.h"
+#include "Random.h"
+#include "SimEvent.h"
+
+class GameLevel;
+struct LevelData;
+struct SimSnapshot;
+class Ball;
+class GameObject;
+class WorkerPool;
+
+enum class GameState {
+    GAME_ACTIVE,
+    GAME_MENU,
+    GAME_WIN,
+};
+
+enum class CollisionMode {
+    // Overlap test at the end of the step, cheap but fast balls can
+    // pass through thin objects
+    Discrete,
+    // The ball is swept along its path and bounces off the first thing
+    // it touches, several times per step if needed
+    Swept,
+};
+
+// Most balls the multi-ball stress mode launches at once. Files read
+// from disk asking for more are rejected.
+const int MAX_LAUNCH_BALLS = 1 << 16;
+
+struct CollisionInfo {
+    bool isCollided;
+    glm::vec2 direction;
+    glm::vec2 displace;
+};
+
+// Screen effects driven by game logic (power-ups, winning). They are
+// part of the simulation state, the renderer only reads them.
+struct SimEffects {
+    bool confuse = false;
+    bool chaos = false;
+};
+
+// The game rules without any window, rendering or audio. Input comes in
+// as an InputState, everything the frontend should react to is
+// reported through Events().
+class Simulation {
+public:
+    Simulation(int width, int height);
+    ~Simulation();
+
+    // Levels are selected in the order they are loaded
+    bool LoadLevel(const std::string& path);
+    // Builds the level from data parsed elsewhere, which may be shared
+    // with other simulations
+    bool LoadLevel(std::shared_ptr<const LevelData> data);
+    void ProcessInput(const InputState& input);
+    void Update(float dt);
+
+    // Events produced since the last call of Update
+    const SimEventQueue& Events() const { return events; }
+
+    GameState State = GameState::GAME_MENU;
+    int Width, Height;
+
+    const GameLevel* GetLevel() const;
+    const LevelData* GetLevelData(int index) const;
+    int GetLevelIndex() const { return level; }
+    int GetLevelCount() const { return (int)levels.size(); }
+    int GetLives() const { return play_ball; }
+    const GameObject* GetPlayer() const { return player.get(); }
+    // Balls in play, the first one is the one served at the start of a
+    // round
+    const std::vector<std::unique_ptr<Ball>>& GetBalls() const {
+        return balls;
+    }
+    // Power-ups falling or in effect, in the order they dropped
+    const std::vector<PowerUp*>& GetPowerUps() const {
+        return powerUps.Active();
+    }
+    const SimEffects& GetEffects() const { return effects; }
+    // Collected power-ups of a type whose effect still lasts
+    int GetActivePowerUps(PowerUpType type) const {
+        return activePowerUps[(int)type];
+    }
+
+    CollisionMode GetCollisionMode() const { return collisionMode; }
+    void SetCollisionMode(CollisionMode mode) { collisionMode = mode; }
+    // Instruction set used to batch test the ball against bricks in
+    // discrete mode, Scalar tests them one by one
+    KernelIsa GetCollisionKernel() const { return collisionKernel; }
+    void SetCollisionKernel(KernelIsa isa) { collisionKernel = isa; }
+
+    // Balls sent off the paddle when a round starts, more than one is
+    // the multi-ball stress mode
+    int GetLaunchBalls() const { return launchCount; }
+    // Clamped to [1, MAX_LAUNCH_BALLS]
+    void SetLaunchBalls(int count) {
+        launchCount = count < 1 ? 1 :
+            count > MAX_LAUNCH_BALLS ? MAX_LAUNCH_BALLS : count;
+    }
+    // Threads moving and colliding the balls. The result does not depend
+    // on it, only the speed does.
+    int GetWorkerCount() const;
+    void SetWorkerCount(int count);
+
+    // Power-up drops are rolled from this seed. Two simulations with the
+    // same seed, settings and input end in the same state.
+    std::uint32_t GetSeed() const { return seed; }
+    void SetSeed(std::uint32_t seed);
+
+    // Copies the complete game state, cheap enough to do every step.
+    // Returns false and leaves snapshot alone when the state does not
+    // fit, more than MAX_SNAPSHOT_BALLS balls (only the multi-ball
+    // stress mode has that many), MAX_SNAPSHOT_POWER_UPS power-ups or
+    // MAX_SNAPSHOT_BRICK_WORDS * 64 bricks over all levels.
+    bool Capture(SimSnapshot& snapshot) const;
+    // Continues from a snapshot of a simulation with the same levels.
+    // Returns false and changes nothing if the levels do not match.
+    bool Restore(const SimSnapshot& snapshot);
+    // Whether Restore would take the snapshot
+    bool CanRestore(const SimSnapshot& snapshot) const;
+
+private:
+
+    int play_ball = 2;
+    int level = 0;
+    CollisionMode collisionMode = CollisionMode::Discrete;
+    KernelIsa collisionKernel = BestKernelIsa();
+    int launchCount = 1;
+    // Extra balls still to be sent off with the next launch
+    int pendingBalls = 0;
+    std::uint32_t seed = 1;
+    Random random{ 1, RandomStream::Gameplay };
+
+    // Objects, their data lives in entities which therefore has to
+    // outlive them
+    EntityStore entities;
+    std::vector<std::unique_ptr<GameObject>> boundary;
+    std::vector<std::unique_ptr<GameLevel>> levels;
+    PowerUpPool powerUps;
+    std::unique_ptr<GameObject> player;
+    std::vector<std::unique_ptr<Ball>> balls;
+    // Balls out of play, reused before new ones are made
+    std::vector<std::unique_ptr<Ball>> spareBalls;
+    // Objects updated every step, in this order. Attached children are
+    // updated by their parent.
+    std::vector<GameObject*> objects;
+
+    SimEffects effects;
+    SimEventQueue events;
+
+    // Something a ball touched in the parallel pass. Contacts only
+    // change the ball itself, their effect on the rest of the game is
+    // applied afterwards in ball order.
+    enum class ContactType { Brick, Player };
+    struct BallContact {
+        ContactType type;
+        EntityStore::Index brick;
+        glm::vec2 position;
+    };
+    // Scratch buffers of one worker
+    struct BallWorkspace {
+        std::vector<EntityStore::Index> brickCandidates;
+        BoxBatch candidateBoxes;
+        CircleHits candidateHits;
+    };
+    std::unique_ptr<WorkerPool> workers;
+    std::vector<BallWorkspace> workspaces;
+    // contacts[i] belongs to balls[i]
+    std::vector<std::vector<BallContact>> contacts;
+
+    void emit(SimEventType type, const glm::vec2& position);
+    void storePreviousPositions();
+
+    // PowerUp
+    // What collecting a power-up of a type does and undoes, indexed by
+    // PowerUpType. Either may be null.
+    struct PowerUpHooks {
+        void (Simulation::*activate)();
+        void (Simulation::*deactivate)();
+    };
+    static const PowerUpHooks powerUpHooks[];
+    int activePowerUps[(int)PowerUpType::Count] = {};
+
+    bool shouldSpawn(int chance);
+    void spawnPowerUps(glm::vec2 position);
+    // Rolls the drops of the bricks destroyed in this step, in the
+    // order they were destroyed
+    void dropPowerUps();
+    void updatePowerUps(float dt);
+    void activatePowerUp(PowerUp* p);
+    void onPowerUpEnd(const PowerUp* p);
+    void activateSpeed();
+    void activateSticky();
+    void deactivateSticky();
+    void activatePassThrough();
+    void deactivatePassThrough();
+    void activatePadSizeIncrease();
+    void activateConfuse();
+    void deactivateConfuse();
+    void activateChaos();
+    void deactivateChaos();
+
+    // Balls
+    Ball* spawnBall(const Ball* source, const glm::vec2& velocity);
+    std::unique_ptr<Ball> makeBall(const Ball* source);
+    // Creates the spare balls a round can need, the launch fan and the
+    // splits, and grows the buffers of the collision pass to match. Steps
+    // of the round then do not allocate.
+    void reserveBalls();
+    void releaseBall(std::unique_ptr<Ball> ball);
+    void launchBalls();
+    void splitBalls();
+    // Returns true when the last ball in play was lost
+    bool dropLostBalls();
+
+    // Collision
+    void moveBalls(float dt);
+    void resolveContacts();
+    void doCollision();
+    // These only touch the ball they are given and may run in parallel
+    void collideBall(Ball* ball, BallWorkspace& work,
+                     std::vector<BallContact>& hits) const;
+    void sweepBall(Ball* ball, BallWorkspace& work,
+                   std::vector<BallContact>& hits) const;
+    void queryBricks(BallWorkspace& work, glm::vec2 min,
+                     glm::vec2 max) const;
+    bool bouncesOffBrick(const Ball* ball, EntityStore::Index brick) const;
+    void bouncePlayer(Ball* ball) const;
+    // Applies a brick contact to the level, the first ball to reach a
+    // brick in a step destroys it
+    void hitBrick(EntityStore::Index brick);
+    bool checkCollision(const GameObject* obj1,
+                        const GameObject* obj2) const;
+    CollisionInfo checkCollision(const Ball* ball,
+                                 const glm::vec2& position,
+                                 const glm::vec2& size) const;
+    glm::vec2 calculateCollisionDirection(const glm::vec2& dir) const;
+    void applyCollision(Ball* ball, const CollisionInfo& info) const;
+
+    // Game Logic
+    void reset_player();
+    // Puts a single ball back on the paddle
+    void reset_ball();
+    void reset_level();
+    void clear_powerups();
+};
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef __SPRITE_H__
+#define __SPRITE_H__
+
+#include <cstdint>
+
+// Identifies the image an object is drawn with. The simulation only
+// knows these ids, the renderer maps them to textures.
+enum class Sprite : std::uint8_t {
+    None,
+    Paddle,
+    Face,
+    Brick,
+    BrickSolid,
+    PowerUpSpeed,
+    PowerUpSticky,
+    PowerUpPassThrough,
+    PowerUpPadSizeIncrease,
+    PowerUpConfuse,
+    PowerUpChaos,
+    PowerUpSplit,
+    Count,
+};
+
+#endif
@@ -0,0 +1,116 @@
+#include "Sweep.h"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+static bool overlapHit(glm::vec2 center, glm::vec2 motion, float radius,
+                       glm::vec2 boxMin, glm::vec2 boxMax,
+                       SweepHit& hit) {
+    glm::vec2 closest = glm::clamp(center, boxMin, boxMax);
+    glm::vec2 dist = center - closest;
+    float dist2 = glm::dot(dist, dist);
+    if (dist2 >= radius * radius) {
+        return false;
+    }
+
+    glm::vec2 normal;
+    if (dist2 > 0.0f) {
+        normal = dist / std::sqrt(dist2);
+    } else {
+        // Center inside the box, leave through the nearest side
+        float left = center.x - boxMin.x;
+        float right = boxMax.x - center.x;
+        float top = center.y - boxMin.y;
+        float bottom = boxMax.y - center.y;
+        float nearest = std::min(std::min(left, right),
+                                 std::min(top, bottom));
+        if (nearest == left) {
+            normal = glm::vec2(-1.0f, 0.0f);
+        } else if (nearest == right) {
+            normal = glm::vec2(1.0f, 0.0f);
+        } else if (nearest == top) {
+            normal = glm::vec2(0.0f, -1.0f);
+        } else {
+            normal = glm::vec2(0.0f, 1.0f);
+        }
+    }
+
+    // Separating already, let it go
+    if (glm::dot(motion, normal) >= 0.0f) {
+        return false;
+    }
+    hit.time = 0.0f;
+    hit.normal = normal;
+    return true;
+}
+
+bool SweepCircleBox(glm::vec2 center, glm::vec2 motion, float radius,
+                    glm::vec2 boxMin, glm::vec2 boxMax, SweepHit& hit) {
+    glm::vec2 closest = glm::clamp(center, boxMin, boxMax);
+    glm::vec2 dist = center - closest;
+    if (glm::dot(dist, dist) < radius * radius) {
+        return overlapHit(center, motion, radius, boxMin, boxMax, hit);
+    }
+    if (motion.x == 0.0f && motion.y == 0.0f) {
+        return false;
+    }
+
+    // Ray against the box grown by the radius
+    glm::vec2 lo = boxMin - glm::vec2(radius);
+    glm::vec2 hi = boxMax + glm::vec2(radius);
+    float enter = -std::numeric_limits<float>::infinity();
+    float exit = std::numeric_limits<float>::infinity();
+    glm::vec2 normal(0.0f);
+    for (int axis = 0; axis < 2; ++axis) {
+        if (motion[axis] == 0.0f) {
+            if (center[axis] < lo[axis] || center[axis] > hi[axis]) {
+                return false;
+            }
+            continue;
+        }
+        float t1 = (lo[axis] - center[axis]) / motion[axis];
+        float t2 = (hi[axis] - center[axis]) / motion[axis];
+        if (t1 > t2) {
+            std::swap(t1, t2);
+        }
+        if (t1 > enter) {
+            enter = t1;
+            normal = glm::vec2(0.0f);
+            normal[axis] = motion[axis] > 0.0f ? -1.0f : 1.0f;
+        }
+        exit = std::min(exit, t2);
+    }
+    if (enter > exit || enter > 1.0f || exit <= 0.0f) {
+        return false;
+    }
+
+    // The grown box has square corners where the real shape is rounded
+    float t = std::max(enter, 0.0f);
+    glm::vec2 point = center + motion * t;
+    bool outsideX = point.x < boxMin.x || point.x > boxMax.x;
+    bool outsideY = point.y < boxMin.y || point.y > boxMax.y;
+    if (!(outsideX && outsideY)) {
+        hit.time = t;
+        hit.normal = normal;
+        return true;
+    }
+
+    glm::vec2 corner(point.x < boxMin.x ? boxMin.x : boxMax.x,
+                     point.y < boxMin.y ? boxMin.y : boxMax.y);
+    glm::vec2 rel = center - corner;
+    float a = glm::dot(motion, motion);
+    float b = glm::dot(motion, rel);
+    float c = glm::dot(rel, rel) - radius * radius;
+    float disc = b * b - a * c;
+    if (disc < 0.0f) {
+        return false;
+    }
+    t = (-b - std::sqrt(disc)) / a;
+    if (t < 0.0f || t > 1.0f) {
+        return false;
+    }
+    hit.time = t;
+    hit.normal = glm::normalize(rel + motion * t);
+    return true;
+}
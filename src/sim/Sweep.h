@@ -0,0 +1,19 @@
+#ifndef __SWEEP_H__
+#define __SWEEP_H__
+
+#include <glm/gtc/type_ptr.hpp>
+
+struct SweepHit {
+    // fraction of the motion at which the shapes first touch
+    float time;
+    // surface normal of the box at the contact, pointing to the circle
+    glm::vec2 normal;
+};
+
+// Finds the earliest time in [0, 1] at which a circle moving from
+// center to center + motion touches the box [boxMin, boxMax]. A circle
+// already overlapping the box hits at time 0 unless it is moving out.
+bool SweepCircleBox(glm::vec2 center, glm::vec2 motion, float radius,
+                    glm::vec2 boxMin, glm::vec2 boxMax, SweepHit& hit);
+
+#endif
@@ -0,0 +1,79 @@
+#include "WorkerPool.h"
+
+#include <algorithm>
+
+WorkerPool::WorkerPool(int workers) {
+    for (int i = 1; i < workers; ++i) {
+        threads.emplace_back(&WorkerPool::work, this, i);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    wake.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void WorkerPool::ParallelFor(int count, int grain, const Job& job) {
+    if (count <= 0) {
+        return;
+    }
+    grain = std::max(grain, 1);
+    if (threads.empty() || count <= grain) {
+        job(0, count, 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->job = &job;
+        this->count = count;
+        this->grain = grain;
+        next = 0;
+        busy = (int)threads.size();
+        ++generation;
+    }
+    wake.notify_all();
+
+    runChunks(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return busy == 0; });
+    this->job = nullptr;
+}
+
+void WorkerPool::work(int worker) {
+    unsigned seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return quit || generation != seen; });
+            if (quit) {
+                return;
+            }
+            seen = generation;
+        }
+
+        runChunks(worker);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--busy == 0) {
+            done.notify_one();
+        }
+    }
+}
+
+void WorkerPool::runChunks(int worker) {
+    for (;;) {
+        int begin = next.fetch_add(grain);
+        if (begin >= count) {
+            return;
+        }
+        (*job)(begin, std::min(begin + grain, count), worker);
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef __WORKERPOOL_H__
+#define __WORKERPOOL_H__
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed set of threads that split a loop over an index range. The
+// calling thread works too, so a pool of one worker runs everything
+// inline without any thread.
+class WorkerPool {
+public:
+    // job(begin, end, worker) handles [begin, end), worker is in
+    // [0, Workers()) and can index per thread scratch data
+    using Job = std::function<void(int begin, int end, int worker)>;
+
+    explicit WorkerPool(int workers);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    int Workers() const { return (int)threads.size() + 1; }
+
+    // Runs job over [0, count) in chunks of grain indices and returns
+    // once all of them are done. Chunks are handed out on demand so
+    // uneven work still spreads over all workers.
+    void ParallelFor(int count, int grain, const Job& job);
+
+private:
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    // The loop being run, valid while busy is non-zero
+    const Job* job = nullptr;
+    int count = 0;
+    int grain = 1;
+    std::atomic<int> next{ 0 };
+    int busy = 0;
+    unsigned generation = 0;
+    bool quit = false;
+
+    void work(int worker);
+    void runChunks(int worker);
+};
+
+#endif
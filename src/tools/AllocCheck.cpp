@@ -0,0 +1,96 @@
+// Plays sessions headless under strict allocation checking, the way
+// --alloc-check guards the game. Each round starts with the ball waiting
+// on the paddle, then strict mode turns on and an autopilot plays on
+// through launches, split power-ups, lost balls and new rounds. Any
+// allocation aborts with the place it was made. With a single ball the
+// check fails too when no session ever split it, since then it did not
+// cover that case.
+//
+//   AllocCheck [level] [sessions] [seconds] [balls] [workers]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include <fmt/core.h>
+
+#include "sim/AllocTracker.h"
+#include "sim/Ball.h"
+#include "sim/GameObject.h"
+#include "sim/Simulation.h"
+
+const float STEP = 1.0f / 120.0f;
+// Steps the ball waits on the paddle before strict mode starts
+static const int WAIT_STEPS = 300;
+
+// Follows the lowest ball that is coming down
+static InputState autopilot(const Simulation& sim) {
+    InputState input;
+    input.launch = true;
+    const Ball* target = nullptr;
+    for (const auto& ball : sim.GetBalls()) {
+        if (ball->Velocity().y > 0.0f &&
+            (!target || ball->Position().y > target->Position().y)) {
+            target = ball.get();
+        }
+    }
+    if (!target) {
+        target = sim.GetBalls().front().get();
+    }
+    const GameObject* player = sim.GetPlayer();
+    float ballX = target->Position().x + target->radius;
+    float paddleX = player->Position().x + player->Size().x / 2.0f;
+    input.left = ballX < paddleX - 10.0f;
+    input.right = ballX > paddleX + 10.0f;
+    return input;
+}
+
+// Most balls in play at once during the session
+static std::size_t runSession(const char* level, unsigned seed,
+                              float seconds, int balls, int workers) {
+    Simulation sim(800, 600);
+    sim.LoadLevel(level);
+    sim.SetLaunchBalls(balls);
+    sim.SetWorkerCount(workers);
+    sim.SetSeed(seed);
+
+    InputState start;
+    start.confirm = true;
+    sim.ProcessInput(start);
+    InputState wait;
+    for (int i = 0; i < WAIT_STEPS; ++i) {
+        sim.ProcessInput(wait);
+        sim.Update(STEP);
+    }
+
+    std::size_t most = sim.GetBalls().size();
+    int steps = (int)std::lround(seconds / STEP);
+    AllocTracker::SetStrict(true);
+    for (int i = 0; i < steps && sim.State == GameState::GAME_ACTIVE; ++i) {
+        sim.ProcessInput(autopilot(sim));
+        sim.Update(STEP);
+        most = std::max(most, sim.GetBalls().size());
+    }
+    AllocTracker::SetStrict(false);
+    return most;
+}
+
+int main(int argc, char** argv) {
+    const char* level = argc > 1 ? argv[1] : "resources/levels/one.lvl";
+    int sessions = argc > 2 ? atoi(argv[2]) : 50;
+    float seconds = argc > 3 ? (float)atof(argv[3]) : 120.0f;
+    int balls = argc > 4 ? std::max(atoi(argv[4]), 1) : 1;
+    int workers = argc > 5 ? std::max(atoi(argv[5]), 1) : 1;
+
+    int splits = 0;
+    for (int i = 0; i < sessions; ++i) {
+        std::size_t most = runSession(level, (unsigned)i + 1, seconds,
+                                      balls, workers);
+        if (most > (std::size_t)balls) {
+            ++splits;
+        }
+    }
+    fmt::print("{} sessions without allocations, {} of them split "
+               "balls\n", sessions, splits);
+    return balls > 1 || splits > 0 ? 0 : 1;
+}
@@ -0,0 +1,109 @@
+// Runs the game headless with many balls on growing numbers of worker
+// threads, reports the time per step and checks that every run ends in
+// the same state. Heap allocations are counted once the launch has
+// settled, a run that makes any fails like one that ends differently.
+//
+//   BallStress [level] [balls] [steps] [max workers]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <cstdlib>
+
+#include <fmt/core.h>
+
+#include "sim/AllocTracker.h"
+#include "sim/Ball.h"
+#include "sim/Simulation.h"
+
+struct RunResult {
+    double seconds;
+    int steps;
+    std::uint64_t hash;
+    std::size_t balls;
+    std::uint64_t allocations;
+};
+
+// Steps before allocations are counted
+static const int WARMUP_STEPS = 60;
+
+static void hashBytes(std::uint64_t& hash, const void* data,
+                      std::size_t size) {
+    auto bytes = (const unsigned char*)data;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+}
+
+static RunResult run(const char* level, int balls, int steps, int workers) {
+    Simulation sim(800, 600);
+    sim.LoadLevel(level);
+    sim.SetLaunchBalls(balls);
+    sim.SetWorkerCount(workers);
+
+    InputState start;
+    start.confirm = true;
+    sim.ProcessInput(start);
+
+    RunResult result;
+    result.hash = 14695981039346656037ull;
+    InputState input;
+    input.launch = true;
+    // The run ends early when the balls clear the level
+    result.steps = 0;
+    AllocStats warm = AllocTracker::Totals();
+    auto begin = std::chrono::steady_clock::now();
+    for (; result.steps < steps && sim.State == GameState::GAME_ACTIVE;
+         ++result.steps) {
+        if (result.steps == WARMUP_STEPS) {
+            warm = AllocTracker::Totals();
+        }
+        sim.ProcessInput(input);
+        sim.Update(1.0f / 120.0f);
+        for (const auto& event : sim.Events()) {
+            hashBytes(result.hash, &event, sizeof(event));
+        }
+    }
+    result.seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - begin).count();
+    result.allocations = result.steps > WARMUP_STEPS ?
+        AllocTracker::Totals().allocations - warm.allocations : 0;
+    for (const auto& ball : sim.GetBalls()) {
+        hashBytes(result.hash, &ball->Position(), sizeof(glm::vec2));
+    }
+    result.balls = sim.GetBalls().size();
+    return result;
+}
+
+int main(int argc, char** argv) {
+    const char* level = argc > 1 ? argv[1] : "resources/levels/one.lvl";
+    int balls = argc > 2 ? atoi(argv[2]) : 4000;
+    int steps = argc > 3 ? atoi(argv[3]) : 600;
+    int cores = argc > 4 ? atoi(argv[4]) :
+        (int)std::thread::hardware_concurrency();
+    cores = std::max(cores, 1);
+
+    fmt::print("{} balls, {} steps\n", balls, steps);
+    auto reference = run(level, balls, steps, 1);
+    bool same = true;
+    bool steady = true;
+    for (int workers = 1; ; workers *= 2) {
+        workers = std::min(workers, cores);
+        auto result = workers == 1 ? reference :
+            run(level, balls, steps, workers);
+        bool match = result.hash == reference.hash;
+        same = same && match;
+        steady = steady && result.allocations == 0;
+        fmt::print("{:3} workers: {:8.3f} ms/step {:6.2f}x {:5} steps "
+                   "{:5} balls left {:6} allocations{}\n",
+                   workers, result.seconds * 1000.0 / result.steps,
+                   reference.seconds / result.seconds, result.steps,
+                   result.balls, result.allocations,
+                   match ? "" : "  MISMATCH");
+        if (workers == cores) {
+            break;
+        }
+    }
+    return same && steady ? 0 : 1;
+}
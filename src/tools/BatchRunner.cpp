@@ -0,0 +1,277 @@
+// Plays many independent sessions headless on a thread pool and writes
+// one line of statistics per session. Every session parses nothing, the
+// level files are read once and shared. With --from every session
+// continues a saved game instead, each with its own power-up drops.
+//
+//   BatchRunner [--sessions N] [--threads N] [--max-time SECONDS]
+//               [--balls N] [--swept-collision] [--format csv|json]
+//               [--from SAVE] [--out FILE] [level files...]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "sim/Ball.h"
+#include "sim/GameLevel.h"
+#include "sim/GameObject.h"
+#include "sim/SaveState.h"
+#include "sim/SimSnapshot.h"
+#include "sim/Simulation.h"
+#include "TaskPool.h"
+
+const float STEP = 1.0f / 120.0f;
+
+struct SessionConfig {
+    int level;
+    // Seeds the power-up drops and varies the autopilot, so sessions
+    // on the same level differ but each one can be run again
+    unsigned seed;
+    float maxTime;
+    int balls;
+    CollisionMode collisionMode;
+    // Saved game to continue, shared by all sessions. Its level and
+    // settings replace the ones above.
+    const SaveHeader* save;
+    const SimSnapshot* saveState;
+};
+
+struct SessionStats {
+    int level;
+    unsigned seed;
+    // "clear", "game-over" or "timeout"
+    const char* outcome;
+    float time;
+    int ballsLost;
+    int powerUps;
+    int bricks;
+    // Share of the level's destructible bricks destroyed at the end
+    float progress;
+};
+
+// Keeps the paddle under the lowest ball that is coming down, aiming
+// at a per session offset from its center
+static InputState autopilot(const Simulation& sim, float aim) {
+    InputState input;
+    input.launch = true;
+    const Ball* target = nullptr;
+    for (const auto& ball : sim.GetBalls()) {
+        if (ball->Velocity().y > 0.0f &&
+            (!target || ball->Position().y > target->Position().y)) {
+            target = ball.get();
+        }
+    }
+    if (!target) {
+        target = sim.GetBalls().front().get();
+    }
+    const GameObject* player = sim.GetPlayer();
+    float ballX = target->Position().x + target->radius;
+    float paddleX = player->Position().x + player->Size().x / 2.0f + aim;
+    input.left = ballX < paddleX - 10.0f;
+    input.right = ballX > paddleX + 10.0f;
+    return input;
+}
+
+static SessionStats runSession(
+    const std::vector<std::shared_ptr<const LevelData>>& levels,
+    const SessionConfig& config) {
+    Simulation sim(800, 600);
+    for (const auto& data : levels) {
+        sim.LoadLevel(data);
+    }
+    sim.SetLaunchBalls(config.balls);
+    sim.SetCollisionMode(config.collisionMode);
+    if (config.saveState) {
+        ApplySaveState(*config.save, *config.saveState, sim);
+    }
+    sim.SetSeed(config.seed);
+
+    // Menu: walk to the level and start
+    InputState menu;
+    menu.nextLevel = true;
+    for (int i = 0; !config.saveState && i < config.level; ++i) {
+        sim.ProcessInput(menu);
+    }
+    InputState start;
+    start.confirm = true;
+    sim.ProcessInput(start);
+
+    SessionStats stats = {};
+    stats.level = sim.GetLevelIndex();
+    stats.seed = config.seed;
+    stats.outcome = "timeout";
+    // Offset in [-40, 40] from a cheap hash of the seed
+    unsigned hash = config.seed * 2654435761u;
+    float aim = (float)(hash >> 16) / 65535.0f * 80.0f - 40.0f;
+
+    int maxSteps = (int)std::lround(config.maxTime / STEP);
+    int step = 0;
+    for (; step < maxSteps; ++step) {
+        sim.ProcessInput(autopilot(sim, aim));
+        sim.Update(STEP);
+        const auto& events = sim.Events();
+        stats.bricks += events.Count(SimEventType::BrickDestroyed);
+        stats.ballsLost += events.Count(SimEventType::BallLost);
+        stats.powerUps += events.Count(SimEventType::PowerUpCollected);
+        bool done = false;
+        if (events.Count(SimEventType::LevelComplete)) {
+            stats.outcome = "clear";
+            done = true;
+        } else if (events.Count(SimEventType::GameOver)) {
+            stats.outcome = "game-over";
+            done = true;
+        }
+        if (done) {
+            ++step;
+            break;
+        }
+    }
+    stats.time = step * STEP;
+    stats.progress = sim.GetLevel()->Progress();
+    return stats;
+}
+
+static void writeCsv(std::FILE* out, const std::vector<SessionStats>& all,
+                     const std::vector<std::string>& levelFiles) {
+    fmt::print(out, "session,level,seed,outcome,time,balls_lost,"
+               "power_ups,bricks,progress\n");
+    for (std::size_t i = 0; i < all.size(); ++i) {
+        const auto& s = all[i];
+        fmt::print(out, "{},{},{},{},{:.3f},{},{},{},{:.3f}\n", i,
+                   levelFiles[s.level], s.seed, s.outcome, s.time,
+                   s.ballsLost, s.powerUps, s.bricks, s.progress);
+    }
+}
+
+static void writeJson(std::FILE* out, const std::vector<SessionStats>& all,
+                      const std::vector<std::string>& levelFiles) {
+    fmt::print(out, "[\n");
+    for (std::size_t i = 0; i < all.size(); ++i) {
+        const auto& s = all[i];
+        fmt::print(out, "  {{\"session\": {}, \"level\": \"{}\", "
+                   "\"seed\": {}, \"outcome\": \"{}\", \"time\": {:.3f}, "
+                   "\"balls_lost\": {}, \"power_ups\": {}, "
+                   "\"bricks\": {}, \"progress\": {:.3f}}}{}\n",
+                   i, levelFiles[s.level], s.seed, s.outcome, s.time,
+                   s.ballsLost, s.powerUps, s.bricks, s.progress,
+                   i + 1 < all.size() ? "," : "");
+    }
+    fmt::print(out, "]\n");
+}
+
+int main(int argc, char** argv) {
+    int sessions = 1000;
+    int threads = (int)std::thread::hardware_concurrency();
+    float maxTime = 600.0f;
+    int balls = 1;
+    CollisionMode collisionMode = CollisionMode::Discrete;
+    bool json = false;
+    const char* outPath = nullptr;
+    const char* savePath = nullptr;
+    std::vector<std::string> levelFiles;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--sessions") && i + 1 < argc) {
+            sessions = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--threads") && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--max-time") && i + 1 < argc) {
+            maxTime = (float)atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--balls") && i + 1 < argc) {
+            balls = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--swept-collision")) {
+            collisionMode = CollisionMode::Swept;
+        } else if (!strcmp(argv[i], "--format") && i + 1 < argc) {
+            json = !strcmp(argv[++i], "json");
+        } else if (!strcmp(argv[i], "--from") && i + 1 < argc) {
+            savePath = argv[++i];
+        } else if (!strcmp(argv[i], "--out") && i + 1 < argc) {
+            outPath = argv[++i];
+        } else {
+            levelFiles.push_back(argv[i]);
+        }
+    }
+    if (levelFiles.empty()) {
+        levelFiles = {
+            "resources/levels/one.lvl",
+            "resources/levels/two.lvl",
+            "resources/levels/three.lvl",
+            "resources/levels/four.lvl",
+        };
+    }
+
+    std::vector<std::shared_ptr<const LevelData>> levels;
+    for (const auto& file : levelFiles) {
+        auto data = LevelData::Load(file);
+        if (!data) {
+            return 1;
+        }
+        levels.push_back(std::move(data));
+    }
+
+    SaveHeader save;
+    std::unique_ptr<SimSnapshot> saveState;
+    if (savePath) {
+        // Check it once here, every session applies it the same way
+        std::vector<std::uint8_t> data;
+        saveState = std::make_unique<SimSnapshot>();
+        Simulation check(800, 600);
+        for (const auto& level : levels) {
+            check.LoadLevel(level);
+        }
+        if (!ReadSaveFile(savePath, data) ||
+            !DecodeSaveState(data.data(), data.size(), save, *saveState) ||
+            !ApplySaveState(save, *saveState, check)) {
+            return 1;
+        }
+    }
+
+    std::vector<SessionStats> results(sessions);
+    auto begin = std::chrono::steady_clock::now();
+    {
+        TaskPool pool(threads);
+        for (int i = 0; i < sessions; ++i) {
+            SessionConfig config;
+            config.level = i % (int)levels.size();
+            config.seed = (unsigned)i;
+            config.maxTime = maxTime;
+            config.balls = balls;
+            config.collisionMode = collisionMode;
+            config.save = &save;
+            config.saveState = saveState.get();
+            pool.Submit([&levels, &results, config, i] {
+                results[i] = runSession(levels, config);
+            });
+        }
+        pool.Wait();
+        threads = pool.Threads();
+    }
+    double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - begin).count();
+
+    std::FILE* out = outPath ? std::fopen(outPath, "w") : stdout;
+    if (!out) {
+        fmt::print(stderr, "Failed opening {}!\n", outPath);
+        return 1;
+    }
+    if (json) {
+        writeJson(out, results, levelFiles);
+    } else {
+        writeCsv(out, results, levelFiles);
+    }
+    if (out != stdout) {
+        std::fclose(out);
+    }
+
+    fmt::print(stderr, "{} sessions on {} threads in {:.2f} s, "
+               "{:.0f} sessions/hour\n", sessions, threads, seconds,
+               sessions / seconds * 3600.0);
+    return 0;
+}
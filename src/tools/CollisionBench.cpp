@@ -0,0 +1,91 @@
+// Times the batch circle vs box tests on every instruction set the CPU
+// supports and checks that they agree with the scalar version.
+//
+//   CollisionBench [boxes] [circles]
+
+#include <chrono>
+#include <random>
+#include <vector>
+#include <cstdlib>
+
+#include <fmt/core.h>
+
+#include "sim/CollisionKernel.h"
+
+int main(int argc, char** argv) {
+    int boxNum = argc > 1 ? atoi(argv[1]) : 50000;
+    int circleNum = argc > 2 ? atoi(argv[2]) : 2000;
+
+    // A level of small bricks like the generated ones
+    std::mt19937 rng(1234);
+    BoxBatch boxes;
+    int columns = 250;
+    float width = 4.0f, height = 2.0f;
+    for (int i = 0; i < boxNum; ++i) {
+        float x = (i % columns) * width;
+        float y = (i / columns) * height;
+        boxes.Add(x, y, x + width, y + height);
+    }
+    float levelWidth = columns * width;
+    float levelHeight = (boxNum / columns + 1) * height;
+
+    std::uniform_real_distribution<float> px(0.0f, levelWidth);
+    std::uniform_real_distribution<float> py(0.0f, levelHeight);
+    std::vector<float> cx(circleNum), cy(circleNum), radius(circleNum);
+    for (int i = 0; i < circleNum; ++i) {
+        cx[i] = px(rng);
+        cy[i] = py(rng);
+        radius[i] = 10.0f;
+    }
+
+    std::vector<KernelIsa> isas = { KernelIsa::Scalar };
+    KernelIsa best = BestKernelIsa();
+    if (best != KernelIsa::Scalar) {
+        isas.push_back(KernelIsa::SSE2);
+    }
+    if (best == KernelIsa::AVX2) {
+        isas.push_back(KernelIsa::AVX2);
+    }
+
+    fmt::print("{} boxes, {} circles\n", boxNum, circleNum);
+    double scalarTime = 0.0;
+    CircleHits hits, reference;
+    for (auto isa : isas) {
+        // Warm up, the timed loop then reuses the result buffers
+        CircleVsBoxes(isa, cx[0], cy[0], radius[0], boxes, hits);
+
+        int count = 0;
+        auto begin = std::chrono::steady_clock::now();
+        for (int c = 0; c < circleNum; ++c) {
+            count += CircleVsBoxes(isa, cx[c], cy[c], radius[c], boxes, hits);
+        }
+        auto end = std::chrono::steady_clock::now();
+        double time = std::chrono::duration<double>(end - begin).count();
+        if (isa == KernelIsa::Scalar) {
+            scalarTime = time;
+        }
+
+        bool same = true;
+        for (int c = 0; c < circleNum && same; ++c) {
+            CircleVsBoxes(KernelIsa::Scalar, cx[c], cy[c], radius[c],
+                          boxes, reference);
+            CircleVsBoxes(isa, cx[c], cy[c], radius[c], boxes, hits);
+            same = hits.mask == reference.mask;
+            for (int i = 0; i < boxNum && same; ++i) {
+                same = !hits.Hit(i) || (hits.dx[i] == reference.dx[i] &&
+                                        hits.dy[i] == reference.dy[i]);
+            }
+        }
+
+        double tests = (double)boxNum * circleNum;
+        fmt::print("{:>7}: {:8.2f} ms {:8.2f} Mtests/s {:5.2f}x "
+                   "{} hits{}\n",
+                   KernelIsaName(isa), time * 1e3, tests / time * 1e-6,
+                   scalarTime / time, count,
+                   same ? "" : " MISMATCH");
+        if (!same) {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+// Plays a recorded session headless as fast as possible, checks that it
+// ends in the recorded state and reports the speed. Repeating the
+// replay makes it a steady benchmark workload.
+//
+//   ReplayRunner FILE [--repeat N] [level files...]
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "sim/Replay.h"
+#include "sim/Simulation.h"
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fmt::print("usage: ReplayRunner FILE [--repeat N] [levels...]\n");
+        return 1;
+    }
+    int repeat = 1;
+    std::vector<std::string> levelFiles;
+    for (int i = 2; i < argc; ++i) {
+        if (!strcmp(argv[i], "--repeat") && i + 1 < argc) {
+            repeat = atoi(argv[++i]);
+        } else {
+            levelFiles.push_back(argv[i]);
+        }
+    }
+    // The levels the game loads
+    if (levelFiles.empty()) {
+        levelFiles = {
+            "resources/levels/one.lvl",
+            "resources/levels/two.lvl",
+            "resources/levels/three.lvl",
+            "resources/levels/four.lvl",
+        };
+    }
+
+    ReplayReader replay;
+    if (!replay.Open(argv[1])) {
+        return 1;
+    }
+    const auto& header = replay.Header();
+
+    bool same = true;
+    double total = 0.0;
+    for (int run = 0; run < repeat; ++run) {
+        Simulation sim(header.width, header.height);
+        for (const auto& file : levelFiles) {
+            if (!sim.LoadLevel(file)) {
+                return 1;
+            }
+        }
+        if (!ApplyReplayHeader(header, sim)) {
+            return 1;
+        }
+
+        replay.Rewind();
+        InputState input;
+        float dt;
+        auto begin = std::chrono::steady_clock::now();
+        while (replay.Next(input, dt)) {
+            sim.ProcessInput(input);
+            sim.Update(dt);
+        }
+        double seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - begin).count();
+        total += seconds;
+
+        bool match = HashState(sim) == header.finalState;
+        same = same && match;
+        fmt::print("run {}: {} steps in {:.3f} ms, {:.0f} steps/s, {}\n",
+                   run, header.steps, seconds * 1000.0,
+                   header.steps / seconds,
+                   match ? "final state matches" : "FINAL STATE DIFFERS");
+    }
+    if (repeat > 1) {
+        fmt::print("mean {:.3f} ms per replay\n", total * 1000.0 / repeat);
+    }
+    return same ? 0 : 1;
+}
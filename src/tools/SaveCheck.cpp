@@ -0,0 +1,87 @@
+// Validates a save file: decodes it and prints what it holds, checks
+// that every number in it is finite, then loads it on
+// the levels it was made on, saves that again and checks that the
+// bytes come out the same.
+//
+//   SaveCheck FILE [level files...]
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "sim/SaveState.h"
+#include "sim/SimSnapshot.h"
+#include "sim/Simulation.h"
+
+static int popcount(std::uint64_t bits) {
+    int count = 0;
+    for (; bits; bits &= bits - 1) {
+        ++count;
+    }
+    return count;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fmt::print("usage: SaveCheck FILE [levels...]\n");
+        return 1;
+    }
+    std::vector<std::string> levelFiles(argv + 2, argv + argc);
+    if (levelFiles.empty()) {
+        levelFiles = {
+            "resources/levels/one.lvl",
+            "resources/levels/two.lvl",
+            "resources/levels/three.lvl",
+            "resources/levels/four.lvl",
+        };
+    }
+
+    std::vector<std::uint8_t> data;
+    if (!ReadSaveFile(argv[1], data)) {
+        return 1;
+    }
+    SaveHeader header;
+    auto snapshot = std::make_unique<SimSnapshot>();
+    if (!DecodeSaveState(data.data(), data.size(), header, *snapshot)) {
+        return 1;
+    }
+    const SimSnapshot& s = *snapshot;
+    int destroyed = 0;
+    for (int i = 0; i < s.brickWords; ++i) {
+        destroyed += popcount(s.destroyedBricks[i]);
+    }
+    fmt::print("version {}, {} bytes, {}x{}, seed {}, {} levels\n",
+               header.version, data.size(), header.width, header.height,
+               header.seed, header.levelHashes.size());
+    fmt::print("state {} on level {}, {} lives, {} balls, {} power-ups, "
+               "{} bricks destroyed\n",
+               s.state, s.level, s.lives, s.ballCount, s.powerUpCount,
+               destroyed);
+
+    if (!IsSnapshotFinite(s)) {
+        fmt::print("Save holds numbers that are not finite!\n");
+        return 1;
+    }
+
+    Simulation sim(header.width, header.height);
+    for (const auto& file : levelFiles) {
+        if (!sim.LoadLevel(file)) {
+            return 1;
+        }
+    }
+    if (!ApplySaveState(header, s, sim)) {
+        return 1;
+    }
+    std::vector<std::uint8_t> again;
+    if (!EncodeSaveState(sim, again)) {
+        return 1;
+    }
+    if (again != data) {
+        fmt::print("Saving the loaded state gives a different file!\n");
+        return 1;
+    }
+    fmt::print("OK\n");
+    return 0;
+}
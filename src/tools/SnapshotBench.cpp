@@ -0,0 +1,149 @@
+// Plays every level headless while capturing a snapshot before each
+// step and regularly rolling back to an older one to play the steps
+// since then again. Reports what capturing and restoring cost and
+// checks that every step ends in the same state as in a run without
+// rollbacks.
+//
+//   SnapshotBench [steps] [rollback steps] [level files...]
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "sim/Ball.h"
+#include "sim/Replay.h"
+#include "sim/SimSnapshot.h"
+#include "sim/Simulation.h"
+
+static const float STEP = 1.0f / 120.0f;
+// Steps between two rollbacks
+static const int ROLLBACK_INTERVAL = 500;
+
+using Clock = std::chrono::steady_clock;
+
+// Keeps the paddle under the lowest ball that is coming down and starts
+// the next round whenever one ends
+static InputState autopilot(const Simulation& sim) {
+    InputState input;
+    input.launch = true;
+    input.confirm = sim.State != GameState::GAME_ACTIVE;
+    const Ball* target = nullptr;
+    for (const auto& ball : sim.GetBalls()) {
+        if (ball->Velocity().y > 0.0f &&
+            (!target || ball->Position().y > target->Position().y)) {
+            target = ball.get();
+        }
+    }
+    if (!target) {
+        target = sim.GetBalls().front().get();
+    }
+    const GameObject* player = sim.GetPlayer();
+    float ballX = target->Position().x + target->radius;
+    float paddleX = player->Position().x + player->Size().x / 2.0f;
+    input.left = ballX < paddleX - 10.0f;
+    input.right = ballX > paddleX + 10.0f;
+    return input;
+}
+
+static void setup(Simulation& sim, const std::vector<std::string>& levels,
+                  int level) {
+    for (const auto& path : levels) {
+        sim.LoadLevel(path);
+    }
+    sim.SetSeed(1000 + level);
+    InputState menu;
+    menu.nextLevel = true;
+    for (int i = 0; i < level; ++i) {
+        sim.ProcessInput(menu);
+    }
+}
+
+static void step(Simulation& sim) {
+    sim.ProcessInput(autopilot(sim));
+    sim.Update(STEP);
+}
+
+int main(int argc, char** argv) {
+    int steps = argc > 1 ? atoi(argv[1]) : 20000;
+    int window = argc > 2 ? atoi(argv[2]) : 120;
+    std::vector<std::string> levels;
+    for (int i = 3; i < argc; ++i) {
+        levels.push_back(argv[i]);
+    }
+    if (levels.empty()) {
+        for (const char* name : { "one", "two", "three", "four" }) {
+            levels.push_back(fmt::format("resources/levels/{}.lvl", name));
+        }
+    }
+    if (window < 1 || window >= ROLLBACK_INTERVAL) {
+        fmt::print("rollback steps must be between 1 and {}\n",
+                   ROLLBACK_INTERVAL - 1);
+        return 1;
+    }
+
+    fmt::print("{} bytes per snapshot, {} steps per level, "
+               "rolling back {} steps every {}\n",
+               sizeof(SimSnapshot), steps, window, ROLLBACK_INTERVAL);
+    std::vector<SimSnapshot> history(window);
+    std::vector<std::uint64_t> expected(steps);
+    bool same = true;
+    for (int level = 0; level < (int)levels.size(); ++level) {
+        // Reference run without snapshots
+        Simulation reference(800, 600);
+        setup(reference, levels, level);
+        for (int i = 0; i < steps; ++i) {
+            step(reference);
+            expected[i] = HashState(reference);
+        }
+
+        Simulation sim(800, 600);
+        setup(sim, levels, level);
+        Clock::duration captureTime{};
+        Clock::duration restoreTime{};
+        int captures = 0;
+        int restores = 0;
+        int mismatches = 0;
+        for (int i = 0; i < steps; ++i) {
+            auto begin = Clock::now();
+            bool captured = sim.Capture(history[i % window]);
+            captureTime += Clock::now() - begin;
+            ++captures;
+            if (!captured) {
+                fmt::print("level {} does not fit a snapshot\n", level);
+                return 1;
+            }
+            step(sim);
+
+            if (i % ROLLBACK_INTERVAL == ROLLBACK_INTERVAL - 1) {
+                // Back to the state before the oldest step kept and
+                // forward again to where we were
+                int from = i - window + 1;
+                begin = Clock::now();
+                sim.Restore(history[from % window]);
+                restoreTime += Clock::now() - begin;
+                ++restores;
+                for (int j = from; j < i; ++j) {
+                    step(sim);
+                    mismatches += HashState(sim) != expected[j];
+                }
+                step(sim);
+            }
+            mismatches += HashState(sim) != expected[i];
+        }
+
+        auto micros = [](Clock::duration d, int n) {
+            return std::chrono::duration<double, std::micro>(d).count() /
+                std::max(n, 1);
+        };
+        fmt::print("{:24} capture {:6.3f} us  restore {:6.3f} us  "
+                   "{:5} mismatched steps\n",
+                   levels[level], micros(captureTime, captures),
+                   micros(restoreTime, restores), mismatches);
+        same = same && mismatches == 0;
+    }
+    return same ? 0 : 1;
+}
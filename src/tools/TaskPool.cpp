@@ -0,0 +1,109 @@
+#include "TaskPool.h"
+
+#include <algorithm>
+
+// Queue of the pool thread running the current code, -1 elsewhere
+static thread_local int currentQueue = -1;
+static thread_local const TaskPool* currentPool = nullptr;
+
+TaskPool::TaskPool(int threadCount) {
+    threadCount = std::max(threadCount, 1);
+    for (int i = 0; i < threadCount; ++i) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    for (int i = 0; i < threadCount; ++i) {
+        threads.emplace_back(&TaskPool::work, this, i);
+    }
+}
+
+TaskPool::~TaskPool() {
+    Wait();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    wake.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void TaskPool::Submit(Task task) {
+    int target = currentPool == this ? currentQueue :
+        (int)(nextQueue++ % queues.size());
+    ++pending;
+    {
+        std::lock_guard<std::mutex> lock(queues[target]->mutex);
+        queues[target]->tasks.push_back(std::move(task));
+    }
+    // Taking the lock orders the push before a sleeping thread's check
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+    }
+    wake.notify_one();
+}
+
+void TaskPool::Wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return pending == 0; });
+}
+
+bool TaskPool::take(int self, Task& task) {
+    {
+        auto& own = *queues[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    int count = (int)queues.size();
+    for (int i = 1; i < count; ++i) {
+        auto& other = *queues[(self + i) % count];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (!other.tasks.empty()) {
+            task = std::move(other.tasks.front());
+            other.tasks.pop_front();
+            ++steals;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskPool::work(int self) {
+    currentQueue = self;
+    currentPool = this;
+    Task task;
+    for (;;) {
+        if (take(self, task)) {
+            task();
+            task = nullptr;
+            if (--pending == 0) {
+                std::lock_guard<std::mutex> lock(mutex);
+                idle.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        if (quit) {
+            return;
+        }
+        // Queued but not running tasks exist somewhere, look again
+        // instead of sleeping through them
+        wake.wait(lock, [&] {
+            if (quit) {
+                return true;
+            }
+            for (auto& queue : queues) {
+                std::lock_guard<std::mutex> queueLock(queue->mutex);
+                if (!queue->tasks.empty()) {
+                    return true;
+                }
+            }
+            return false;
+        });
+    }
+}
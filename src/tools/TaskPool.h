@@ -0,0 +1,61 @@
+#ifndef __TASKPOOL_H__
+#define __TASKPOOL_H__
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Runs independent tasks on a set of threads. Every thread has its own
+// queue and takes its newest task first; a thread that runs dry steals
+// the oldest task of another one, so long and short tasks even out
+// without a shared queue everybody contends on.
+class TaskPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit TaskPool(int threads);
+    ~TaskPool();
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    int Threads() const { return (int)threads.size(); }
+
+    // Tasks submitted from outside the pool are dealt round robin, the
+    // ones submitted by a running task go to its own thread
+    void Submit(Task task);
+    // Blocks until every submitted task has finished
+    void Wait();
+
+    // Tasks taken from another thread's queue so far
+    long Steals() const { return steals; }
+
+private:
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> threads;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    // Submitted but not yet finished
+    std::atomic<long> pending{ 0 };
+    std::atomic<unsigned> nextQueue{ 0 };
+    std::atomic<long> steals{ 0 };
+    bool quit = false;
+
+    void work(int self);
+    bool take(int self, Task& task);
+};
+
+#endif
@@ -4,7 +4,24 @@ add_requires("opengl", "glfw", "glad", "glm", "fmt", "freetype")
 
 set_defaultmode("debug")
 
+-- Game rules only, no window, rendering or audio. Can be linked into
+-- headless tools.
+target("BreakOutSim") do
+   add_packages("glm", "fmt")
+   set_kind("static")
+   add_files("src/sim/*.cpp")
+   set_languages("c++17")
+   if is_plat("linux") then
+      add_syslinks("pthread", {public = true})
+   end
+   -- Attribute heap allocations to ALLOC_SCOPE sites
+   if is_mode("debug") then
+      add_defines("BREAKOUT_ALLOC_SITES", {public = true})
+   end
+end
+
 target("BreakOut") do
+   add_deps("BreakOutSim")
    add_packages("opengl", "glfw", "glad", "glm", "fmt", "freetype")
    set_kind("binary")
    add_files("src/*.cpp")
@@ -21,6 +38,88 @@ target("BreakOut") do
    end
 end
 
+-- Times the batched collision kernel for every instruction set the CPU
+-- supports and checks the results against the scalar one.
+target("CollisionBench") do
+   add_deps("BreakOutSim")
+   add_packages("glm", "fmt")
+   set_kind("binary")
+   add_files("src/tools/CollisionBench.cpp")
+   add_includedirs("./src/")
+   set_languages("c++17")
+end
+
+-- Plays a level headless with thousands of balls on 1, 2, 4... worker
+-- threads and checks that all runs end the same.
+target("BallStress") do
+   add_deps("BreakOutSim")
+   add_packages("glm", "fmt")
+   set_kind("binary")
+   add_files("src/tools/BallStress.cpp")
+   add_includedirs("./src/")
+   set_languages("c++17")
+   set_rundir("$(projectdir)")
+end
+
+-- Plays sessions headless with strict allocation checking and fails on
+-- the first allocation after the ball waited on the paddle.
+target("AllocCheck") do
+   add_deps("BreakOutSim")
+   add_packages("glm", "fmt")
+   set_kind("binary")
+   add_files("src/tools/AllocCheck.cpp")
+   add_includedirs("./src/")
+   set_languages("c++17")
+   set_rundir("$(projectdir)")
+end
+
+-- Plays many sessions headless on a work-stealing thread pool and
+-- writes per session statistics as CSV or JSON.
+target("BatchRunner") do
+   add_deps("BreakOutSim")
+   add_packages("glm", "fmt")
+   set_kind("binary")
+   add_files("src/tools/BatchRunner.cpp", "src/tools/TaskPool.cpp")
+   add_includedirs("./src/")
+   set_languages("c++17")
+   set_rundir("$(projectdir)")
+end
+
+-- Replays a recording headless at full speed and checks the final state.
+target("ReplayRunner") do
+   add_deps("BreakOutSim")
+   add_packages("glm", "fmt")
+   set_kind("binary")
+   add_files("src/tools/ReplayRunner.cpp")
+   add_includedirs("./src/")
+   set_languages("c++17")
+   set_rundir("$(projectdir)")
+end
+
+-- Times snapshot capture and restore and checks that rolling back and
+-- playing forward again ends every step in the same state.
+target("SnapshotBench") do
+   add_deps("BreakOutSim")
+   add_packages("glm", "fmt")
+   set_kind("binary")
+   add_files("src/tools/SnapshotBench.cpp")
+   add_includedirs("./src/")
+   set_languages("c++17")
+   set_rundir("$(projectdir)")
+end
+
+-- Validates a save file and checks that loading and saving it again
+-- gives the same bytes.
+target("SaveCheck") do
+   add_deps("BreakOutSim")
+   add_packages("glm", "fmt")
+   set_kind("binary")
+   add_files("src/tools/SaveCheck.cpp")
+   add_includedirs("./src/")
+   set_languages("c++17")
+   set_rundir("$(projectdir)")
+end
+
 --
 -- If you want to known more usage about xmake, please see https://xmake.io
 --